@@ -0,0 +1,112 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "belief.h"
+#include "suitpermutation.h"
+
+#include <QLoggingCategory>
+
+Q_DECLARE_LOGGING_CATEGORY(klaverjasAi)
+
+namespace {
+
+using Rank = Card::Rank;
+
+/* Rough likelihood ratios following BidHeuristic, which bids a suit whose top
+ * runs are worth over 40 points, or 20 points with four or more cards. Both
+ * mostly depend on holding the Jack and Nine, and to a lesser extent on the
+ * length of the suit.
+ */
+const qreal PassJack = 0.3;
+const qreal PassNine = 0.5;
+const qreal PassOther = 0.8;
+const qreal BidJack = 3;
+const qreal BidNine = 2;
+const qreal BidOther = 1.5;
+
+} // namespace
+
+Belief::Belief()
+{
+    for (auto &w : m_weights)
+        w.fill(1);
+}
+
+/* Only a choice reveals anything: a bid the player was obliged to make says
+ * nothing about their hand, and neither do the suits they were offered but
+ * did not choose when they could not pass.
+ */
+void Belief::observeBid(uint player, const QVariantList &options, const QVariant &bid)
+{
+    if (player > 3 || options.isEmpty() || !options.last().isNull())
+        return;
+    if (bid.isNull()) {
+        for (const auto &option : options) {
+            if (!option.isNull())
+                scale(player, option.value<Card::Suit>(), PassJack, PassNine, PassOther);
+        }
+    } else {
+        scale(player, bid.value<Card::Suit>(), BidJack, BidNine, BidOther);
+    }
+    qCDebug(klaverjasAi) << "Player" << player << (bid.isNull() ? "passed" : "bid") << "on" << options;
+}
+
+qreal Belief::weight(uint player, Card card) const
+{
+    return m_weights[player][card.id()];
+}
+
+Belief Belief::relabelled(const SuitPermutation &permutation) const
+{
+    Belief belief;
+    for (uint id = 0; id < 32; ++id) {
+        const auto target = permutation.map(Card::fromId(id)).id();
+        for (uint p = 0; p < 4; ++p)
+            belief.m_weights[p][target] = m_weights[p][id];
+    }
+    return belief;
+}
+
+/* The signals are those of Trick::Signal. They are taken as likely rather
+ * than certain, since the player may also just have discarded a card they did
+ * not need.
+ */
+qreal Belief::signalWeight(Card card, Trick::Signal signal)
+{
+    const auto rank = card.rank();
+    const bool isHigh = rank == Rank::Ace || rank == Rank::Ten;
+    switch (signal) {
+    case Trick::Signal::High:
+        return isHigh ? 2 : 1;
+    case Trick::Signal::Low:
+        return isHigh ? 0.25 : 1;
+    case Trick::Signal::Long:
+        return rank == Rank::Ten ? 3 : rank == Rank::King || rank == Rank::Queen || rank == Rank::Jack ? 1.5 : 1;
+    default:
+        return 1;
+    }
+}
+
+void Belief::scale(uint player, Card::Suit suit, qreal jack, qreal nine, qreal other)
+{
+    for (const auto rank : Card::Ranks) {
+        const auto factor = rank == Rank::Jack ? jack : rank == Rank::Nine ? nine : other;
+        m_weights[player][Card(suit, rank).id()] *= float(factor);
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BELIEF_H
+#define BELIEF_H
+
+#include "card.h"
+#include "trick.h"
+
+#include <QVariant>
+#include <QVariantList>
+
+#include <array>
+
+class SuitPermutation;
+
+/**
+ * What the other players may infer about a player's cards from their bids and
+ * signals.
+ *
+ * Each card has a weight for each player, the factor by which holding it
+ * makes that player's observed behaviour more or less likely. All weights
+ * start at 1, i.e. no information. A bid is observed like the BidHeuristic
+ * makes it: a player who passes a suit seldom holds its Jack and Nine, and a
+ * player who chooses a suit while allowed to pass probably does. Signals,
+ * which players give in the cards they discard to their partner, weigh the
+ * high cards of their suit in the same way, see signalWeight.
+ *
+ * GameEngine uses the weights to prefer likely deals when it determinises the
+ * hidden cards, see GameEngine::setBelief.
+ */
+class Belief
+{
+public:
+    /// Deals drawn by each determinisation, of which one is kept
+    static const int Samples = 4;
+
+    /// A belief without information
+    Belief();
+
+    /// Update the weights of a player's cards by their choice of a bid from
+    /// the options, where a null bid is a pass
+    void observeBid(uint player, const QVariantList &options, const QVariant &bid);
+    /// The weight of the given player holding the card
+    qreal weight(uint player, Card card) const;
+    /// This belief with its suits relabelled, see SuitPermutation
+    Belief relabelled(const SuitPermutation &permutation) const;
+
+    /// The weight of a player holding the card if they gave the signal in its
+    /// suit
+    static qreal signalWeight(Card card, Trick::Signal signal);
+
+private:
+    void scale(uint player, Card::Suit suit, qreal jack, qreal nine, qreal other);
+
+    std::array<std::array<float,32>,4> m_weights;
+};
+
+#endif // BELIEF_H
@@ -0,0 +1,247 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+/*
+ * Benchmark the AI search on random positions. SearchTree is first compared
+ * with the generic solver of the ismcsolver library, and then run with
+ * increasing numbers of threads sharing its tree, optionally fed by producer
+ * threads that determinise states for them. The throughput is reported
+ * in iterations per second, the memory as the heap growth per iteration, i.e.
+ * per node, and the quality as the share of moves that agree with a long
+ * single threaded search of each position. A long search of the first
+ * position under a memory limit checks that its heap stays within the limit,
+ * and the program fails if it does not. With producers, the rates of both
+ * pipeline stages and the times each waited for the other are reported too.
+ */
+
+#include "gameengine.h"
+#include "players/baseplayer.h"
+#include "search/searchtree.h"
+#include <ismcts/sosolver.h>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QStringList>
+#include <QTextStream>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Heap in use and its peak, counted by the operator new and delete below
+std::atomic<qint64> heapBytes(0);
+std::atomic<qint64> heapPeak(0);
+
+// Blocks carry their size in a header that keeps the usual alignment
+const std::size_t HeapHeader = 16;
+
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    auto block = static_cast<char *>(std::malloc(size + HeapHeader));
+    if (!block)
+        throw std::bad_alloc();
+    *reinterpret_cast<std::size_t *>(block) = size;
+    const qint64 bytes = heapBytes += qint64(size);
+    qint64 peak = heapPeak;
+    while (bytes > peak && !heapPeak.compare_exchange_weak(peak, bytes)) {
+    }
+    return block + HeapHeader;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    if (!pointer)
+        return;
+    auto block = static_cast<char *>(pointer) - HeapHeader;
+    heapBytes -= qint64(*reinterpret_cast<std::size_t *>(block));
+    std::free(block);
+}
+
+namespace {
+
+/* Deal random hands and play random moves up to a random point of the round,
+ * where the player to move has a real choice
+ */
+std::unique_ptr<GameEngine> randomPosition(std::mt19937 &random)
+{
+    QVector<Card> deck;
+    for (const auto suit : Card::Suits) {
+        for (const auto rank : Card::Ranks)
+            deck << Card(suit, rank);
+    }
+    std::shuffle(deck.begin(), deck.end(), random);
+    GameEngine::PlayerList players;
+    for (int p = 0; p < 4; ++p) {
+        players << std::make_shared<BasePlayer>();
+        players.last()->setHand(deck.mid(p * 8, 8));
+    }
+    const auto first = GameEngine::Position(random() % 4);
+    const auto trump = Card::Suits[random() % 4];
+    auto engine = GameEngine::create(players, first, first, TrumpRule::Amsterdams, trump);
+
+    const int cards = random() % 24;
+    for (int i = 0; i < cards; ++i) {
+        const auto moves = engine->validMoves();
+        engine->doMove(moves[random() % moves.size()]);
+    }
+    while (!engine->isFinished() && engine->equivalenceClasses(engine->validMoves()).size() < 2)
+        engine->doMove(engine->validMoves().front());
+    if (engine->isFinished())
+        return randomPosition(random);
+    auto root = engine->clone();
+    root->setMergeEquivalentMoves(true);
+    root->setEarlyTermination(true);
+    return root;
+}
+
+// The heap growth during a call, divided by the given number of iterations
+template<typename Search>
+qint64 heapPerIteration(Search search, int iterations)
+{
+    const qint64 baseline = heapBytes;
+    heapPeak = baseline;
+    search();
+    return (heapPeak - baseline) / iterations;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName(QStringLiteral("klaverjas-bench"));
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmark the AI search on random positions against the library solver and with different numbers of threads.");
+    parser.addHelpOption();
+    const QCommandLineOption positionsOption("positions", "Number of random positions.", "n", "20");
+    const QCommandLineOption iterationsOption("iterations", "Iterations per search.", "n", "10000");
+    const QCommandLineOption referenceOption("reference", "Iterations of the single threaded reference search.", "n", "200000");
+    const QCommandLineOption threadsOption("threads", "Comma separated thread counts.", "list", "1,2,4,8,16,32");
+    const QCommandLineOption memoryOption("memory-limit", "Memory limit of the capped search in KiB.", "KiB", "1024");
+    const QCommandLineOption producersOption("producers", "Producer threads determinising states for the searches.", "n", "0");
+    const QCommandLineOption seedOption("seed", "Seed of the random positions.", "n", "1");
+    parser.addOptions({positionsOption, iterationsOption, referenceOption, threadsOption, memoryOption, producersOption, seedOption});
+    parser.process(app);
+    QLoggingCategory::setFilterRules("klaverjas.*.debug=false");
+
+    const int positions = parser.value(positionsOption).toInt();
+    const int iterations = parser.value(iterationsOption).toInt();
+    const int referenceIterations = parser.value(referenceOption).toInt();
+    const int producers = parser.value(producersOption).toInt();
+    const qint64 memoryLimit = parser.value(memoryOption).toLongLong() * 1024;
+    std::vector<int> threadCounts;
+    for (const auto &count : parser.value(threadsOption).split(',', QString::SkipEmptyParts))
+        threadCounts.push_back(count.toInt());
+    if (positions < 1 || iterations < 1 || referenceIterations < 1 || producers < 0 || memoryLimit < 1
+            || std::any_of(threadCounts.begin(), threadCounts.end(), [](int t) { return t < 1; })) {
+        std::fprintf(stderr, "Invalid number of positions, iterations or threads\n");
+        return 2;
+    }
+
+    QTextStream out(stdout);
+    std::mt19937 random(parser.value(seedOption).toUInt());
+    std::vector<std::unique_ptr<GameEngine>> roots;
+    std::vector<Card> references;
+    for (int i = 0; i < positions; ++i) {
+        roots.push_back(randomPosition(random));
+        SearchTree reference(referenceIterations);
+        references.push_back(reference(*roots.back()));
+    }
+    out << "positions " << positions << " iterations " << iterations << " reference " << referenceIterations << endl;
+
+    for (const bool isLibrary : {true, false}) {
+        int agreed = 0;
+        qint64 heap = 0;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < positions; ++i) {
+            Card move;
+            if (isLibrary) {
+                ISMCTS::SOSolver<Card> solver(iterations);
+                heap += heapPerIteration([&]{ move = solver(*roots[i]); }, iterations);
+            } else {
+                SearchTree search(iterations);
+                heap += heapPerIteration([&]{ move = search(*roots[i]); }, iterations);
+            }
+            if (move == references[i])
+                ++agreed;
+        }
+        const qint64 elapsed = qMax<qint64>(timer.elapsed(), 1);
+        out << "search " << (isLibrary ? "library" : "tree") << " time " << elapsed << " ms iterations/s "
+            << qint64(positions) * iterations * 1000 / elapsed << " bytes/node " << heap / positions
+            << " agreement " << 100 * agreed / positions << '%' << endl;
+    }
+    out << "tree node size " << SearchTree::nodeSize() << " bytes" << endl;
+
+    // The heap kept by the tree, not the temporaries of its iterations
+    bool isWithinLimit;
+    {
+        const qint64 baseline = heapBytes;
+        SearchTree capped(referenceIterations);
+        capped.setMemoryLimit(memoryLimit);
+        capped(*roots.front());
+        const qint64 heap = heapBytes - baseline;
+        const auto statistics = capped.statistics();
+        isWithinLimit = heap <= memoryLimit;
+        out << "memory limit " << memoryLimit / 1024 << " KiB heap " << heap / 1024 << " KiB tree "
+            << statistics.memory / 1024 << " KiB prunes " << statistics.prunes
+            << (isWithinLimit ? " ok" : " EXCEEDED") << endl;
+    }
+
+    for (const int threads : threadCounts) {
+        int agreed = 0;
+        SearchTree::Statistics total = {};
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < positions; ++i) {
+            SearchTree search(iterations);
+            search.setThreads(threads);
+            search.setProducers(producers);
+            if (search(*roots[i]) == references[i])
+                ++agreed;
+            const auto statistics = search.statistics();
+            total.time += statistics.time;
+            total.determinisations += statistics.determinisations;
+            total.producerStalls += statistics.producerStalls;
+            total.consumerStalls += statistics.consumerStalls;
+        }
+        const qint64 elapsed = qMax<qint64>(timer.elapsed(), 1);
+        out << "threads " << threads << " time " << elapsed << " ms iterations/s "
+            << qint64(positions) * iterations * 1000 / elapsed
+            << " agreement " << 100 * agreed / positions << '%' << endl;
+        if (producers > 0) {
+            const qint64 searchTime = qMax<qint64>(total.time, 1);
+            out << "  producers " << producers << " determinisations/s " << total.determinisations * 1000 / searchTime
+                << " producer stalls " << total.producerStalls << " searcher stalls " << total.consumerStalls << endl;
+        }
+    }
+    return isWithinLimit ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "bidding.h"
+
+
+Bidding::Bidding(BidRule rule)
+    : m_rule(rule)
+    , m_counter(0)
+    , m_isFirstRound(true)
+    , m_drawnSuit(Card::Suit::Clubs)
+{
+}
+
+BidRule Bidding::rule() const
+{
+    return m_rule;
+}
+
+void Bidding::start(bool isFirstRound)
+{
+    m_options.clear();
+    m_counter = 0;
+    m_isFirstRound = isFirstRound;
+}
+
+bool Bidding::isStarting() const
+{
+    return m_counter == 0;
+}
+
+QVariantList Bidding::next(std::mt19937 &random)
+{
+    if (m_counter == 0) {
+        m_options = initialOptions(random);
+    } else if (m_counter % 4 == 0) {
+        // All players have passed in the first round of bidding. Under the
+        // Twents rule, a random suit becomes trumps.
+        if (m_rule == BidRule::Twents) {
+            m_drawnSuit = Card::Suits[random() % 4];
+            return {};
+        }
+        refineOptions();
+    }
+    ++m_counter;
+    return m_options;
+}
+
+Card::Suit Bidding::drawnSuit() const
+{
+    return m_drawnSuit;
+}
+
+QVariantList Bidding::options(const QVector<Card::Suit> suits)
+{
+    QVariantList options;
+    for (const auto &s : suits)
+        options << QVariant::fromValue(s);
+    return options;
+}
+
+QVariantList Bidding::initialOptions(std::mt19937 &random) const
+{
+    const auto allOptions = options();
+    switch (m_rule) {
+    case BidRule::Official:
+        return {allOptions, QVariant()};
+    case BidRule::Utrechts:
+        return allOptions;
+    default:
+        // For Random and Twents games, the first choice in a game is Clubs,
+        // otherwise a random suit is chosen.
+        if (m_isFirstRound)
+            return options({Card::Suit::Clubs}) << QVariant();
+        else
+            return {allOptions[random() % 4], QVariant()};
+    }
+}
+
+void Bidding::refineOptions()
+{
+    Q_ASSERT(m_rule != BidRule::Utrechts);
+    if (m_rule == BidRule::Random) {
+        const auto forbidden = m_options.first();
+        m_options.clear();
+        for (const auto bid : options()) {
+            if (bid != forbidden)
+                m_options << bid;
+        }
+    } else if (m_rule == BidRule::Official) {
+        m_options.removeLast();
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BIDDING_H
+#define BIDDING_H
+
+#include "card.h"
+#include "rules.h"
+
+#include <QVariantList>
+
+#include <random>
+
+/**
+ * Bidding phase of a round.
+ *
+ * Keeps track of the options offered to each player in turn under the given
+ * BidRule. The options are bid as QVariants holding a Card::Suit, while a null
+ * QVariant means passing.
+ */
+class Bidding
+{
+public:
+    explicit Bidding(BidRule rule = BidRule::Random);
+
+    BidRule rule() const;
+    /// Start a new bidding phase. Some rules offer a fixed suit in the first
+    /// round of a game.
+    void start(bool isFirstRound);
+    /// Whether no options have been offered since the last start()
+    bool isStarting() const;
+    /**
+     * Proceed to the next player's bid.
+     *
+     * @param random Draws the suits that some rules choose at random.
+     * @return The options for the next player, or an empty list if all players
+     *      passed and the trump suit was drawn instead (see drawnSuit).
+     */
+    QVariantList next(std::mt19937 &random);
+    /// The suit drawn when all players passed under the Twents rule
+    Card::Suit drawnSuit() const;
+
+    /// Convert suits to bid options
+    static QVariantList options(const QVector<Card::Suit> suits = Card::Suits);
+
+private:
+    QVariantList initialOptions(std::mt19937 &random) const;
+    void refineOptions();
+
+    QVariantList m_options;
+    BidRule m_rule;
+    int m_counter;
+    bool m_isFirstRound;
+    Card::Suit m_drawnSuit;
+};
+
+#endif // BIDDING_H
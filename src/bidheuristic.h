@@ -0,0 +1,42 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BIDHEURISTIC_H
+#define BIDHEURISTIC_H
+
+#include "cardset.h"
+
+#include <QVariant>
+#include <QVariantList>
+
+/**
+ * Bidding by hand strength.
+ *
+ * Each trump option is scored by the values of the top runs it would give the
+ * hand, which indicates how many tricks the player might secure.
+ */
+namespace BidHeuristic
+{
+
+/// Choose one of the bid options for the given hand
+QVariant choose(const CardSet &hand, const QVariantList &options);
+
+} // namespace BidHeuristic
+
+#endif // BIDHEURISTIC_H
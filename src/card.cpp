@@ -88,6 +88,16 @@ bool Card::beats(const Card& other, const Order order) const
     return suit() == other.suit() && order[rank()] > order[other.rank()];
 }
 
+uint Card::id() const
+{
+    return suitIndex(suit()) * 8 + rankIndex(rank());
+}
+
+Card Card::fromId(uint id)
+{
+    return Card(Suit((id / 8) << 4), Rank(id % 8 + uchar(Rank::Seven)));
+}
+
 bool Card::operator==(const Card& other) const
 {
     return m_value == other.m_value;
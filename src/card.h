@@ -43,6 +43,14 @@ public:
 
     bool operator==(const Card& other) const;
 
+    /// Index (0-31) of this card, combining the suit and rank indices below
+    uint id() const;
+    static Card fromId(uint id);
+    /// Index (0-3) of the suit, taken from the high nibble of its value
+    static uint suitIndex(Suit suit) { return uchar(suit) >> 4; }
+    /// Index (0-7) of the rank, i.e. its bit position in a suit's rank mask
+    static uint rankIndex(Rank rank) { return uchar(rank) - uchar(Rank::Seven); }
+
     /* Whether this card beats the other in the given sorting order.
      */
     bool beats(const Card& other, const Order order) const;
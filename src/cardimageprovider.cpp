@@ -18,29 +18,160 @@
  */
 
 #include "cardimageprovider.h"
+#include "card.h"
+#include "trace.h"
 
+#include <QMutexLocker>
 #include <QPainter>
+#include <QRunnable>
+
+#include <climits>
+
+namespace {
+
+const QString AtlasId = QStringLiteral("atlas");
+const QString BackId = QStringLiteral("back");
+
+QString elementId(Card::Suit suit, Card::Rank rank)
+{
+    static const QHash<Card::Rank,QString> ranks = {
+        {Card::Rank::Seven, "7"}, {Card::Rank::Eight, "8"}, {Card::Rank::Nine, "9"},
+        {Card::Rank::Ten, "10"}, {Card::Rank::Jack, "jack"}, {Card::Rank::Queen, "queen"},
+        {Card::Rank::King, "king"}, {Card::Rank::Ace, "1"}
+    };
+    static const QHash<Card::Suit,QString> suits = {
+        {Card::Suit::Clubs, "club"}, {Card::Suit::Diamonds, "diamond"},
+        {Card::Suit::Hearts, "heart"}, {Card::Suit::Spades, "spade"}
+    };
+    return ranks[rank] + '_' + suits[suit];
+}
+
+QString cacheKey(const QString &id, const QSize &size)
+{
+    return QString("%1@%2x%3").arg(id).arg(size.width()).arg(size.height());
+}
+
+// Renders one request on the provider's thread pool
+class CardImageResponse : public QQuickImageResponse, public QRunnable
+{
+public:
+    CardImageResponse(CardImageProvider *provider, const QString &id, const QSize &requestedSize)
+        : m_provider(provider)
+        , m_id(id)
+        , m_requestedSize(requestedSize)
+    {
+        // The engine deletes the response once it is finished
+        setAutoDelete(false);
+    }
+
+    QQuickTextureFactory *textureFactory() const override
+    {
+        return QQuickTextureFactory::textureFactoryForImage(m_image);
+    }
+
+    QString errorString() const override
+    {
+        return m_image.isNull() ? QString("Unknown card image %1").arg(m_id) : QString();
+    }
+
+    void run() override
+    {
+        m_image = m_provider->requestImage(m_id, nullptr, m_requestedSize);
+        emit finished();
+    }
+
+private:
+    CardImageProvider *m_provider;
+    QString m_id;
+    QSize m_requestedSize;
+    QImage m_image;
+};
+
+} // namespace
 
 CardImageProvider::CardImageProvider()
-    : QQuickImageProvider(QQuickImageProvider::Pixmap)
-    , m_renderer(QString("/usr/share/carddecks/svg-oxygen-air/oxygen-air.svgz"))
+    : m_renderer(QString("/usr/share/carddecks/svg-oxygen-air/oxygen-air.svgz"))
+    , m_cache(CacheSize)
+{
+    QStringList ids(BackId);
+    for (const auto suit : Card::Suits) {
+        for (const auto rank : Card::Ranks)
+            ids << elementId(suit, rank);
+    }
+    for (const auto &id : ids) {
+        if (m_renderer.elementExists(id))
+            m_elementSizes[id] = m_renderer.boundsOnElement(id).toRect().size();
+    }
+}
+
+QQuickImageResponse *CardImageProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
 {
+    auto response = new CardImageResponse(this, id, requestedSize);
+    m_pool.start(response);
+    return response;
 }
 
-QPixmap CardImageProvider::requestPixmap(const QString& id, QSize* size, const QSize& requestedSize)
+QImage CardImageProvider::requestImage(const QString& id, QSize* size, const QSize& requestedSize)
 {
-    QPixmap pixmap;
-    if (!m_renderer.elementExists(id))
-        return pixmap;
-    QSize cardSize = m_renderer.boundsOnElement(id).toRect().size();
+    KLAVERJAS_TRACE("images", "CardImageProvider::requestImage");
+    QSize naturalSize;
+    if (id == AtlasId && m_elementSizes.contains(BackId))
+        naturalSize = QSize(AtlasColumns * m_elementSizes[BackId].width(), AtlasRows * m_elementSizes[BackId].height());
+    else if (m_elementSizes.contains(id))
+        naturalSize = m_elementSizes[id];
+    else
+        return QImage();
     if (size)
-        *size = cardSize;
+        *size = naturalSize;
+
+    const QSize imageSize = this->imageSize(naturalSize, requestedSize);
+    const auto key = cacheKey(id, imageSize);
+    {
+        QMutexLocker lock(&m_cacheMutex);
+        if (const auto cached = m_cache.object(key))
+            return *cached;
+    }
+    const QImage result = render(id, imageSize);
+    QMutexLocker lock(&m_cacheMutex);
+    m_cache.insert(key, new QImage(result), qMax(1, result.byteCount() / 1024));
+    return result;
+}
+
+// A single requested dimension scales the other one along
+QSize CardImageProvider::imageSize(const QSize &naturalSize, const QSize &requestedSize) const
+{
+    if (requestedSize.width() > 0 && requestedSize.height() > 0)
+        return requestedSize;
     if (requestedSize.width() > 0)
-        cardSize.setWidth(requestedSize.width());
+        return naturalSize.scaled(requestedSize.width(), INT_MAX, Qt::KeepAspectRatio);
     if (requestedSize.height() > 0)
-        cardSize.setHeight(requestedSize.height());
-    pixmap = QPixmap(cardSize);
-    QPainter painter(&pixmap);
-    m_renderer.render(&painter, id);
-    return pixmap;
+        return naturalSize.scaled(INT_MAX, requestedSize.height(), Qt::KeepAspectRatio);
+    return naturalSize;
+}
+
+QImage CardImageProvider::render(const QString &id, const QSize &size)
+{
+    KLAVERJAS_TRACE("images", "CardImageProvider::render");
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    if (id != AtlasId) {
+        renderElement(&painter, id, image.rect());
+        return image;
+    }
+    const QSizeF cell(qreal(size.width()) / AtlasColumns, qreal(size.height()) / AtlasRows);
+    for (const auto suit : Card::Suits) {
+        for (const auto rank : Card::Ranks) {
+            const QPointF topLeft(Card::rankIndex(rank) * cell.width(), Card::suitIndex(suit) * cell.height());
+            renderElement(&painter, elementId(suit, rank), QRectF(topLeft, cell));
+        }
+    }
+    renderElement(&painter, BackId, QRectF(QPointF(0, 4 * cell.height()), cell));
+    return image;
+}
+
+void CardImageProvider::renderElement(QPainter *painter, const QString &id, const QRectF &bounds)
+{
+    QMutexLocker lock(&m_rendererMutex);
+    m_renderer.render(painter, id, bounds);
 }
@@ -20,22 +20,57 @@
 #ifndef CARDIMAGEPROVIDER_H
 #define CARDIMAGEPROVIDER_H
 
-#include <QQuickImageProvider>
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QQuickAsyncImageProvider>
 #include <QSvgRenderer>
+#include <QThreadPool>
+
+class QPainter;
 
 /** Card image provider class.
  *
- * This is a simple wrapper around a QSvgRenderer, which paints the requested
- * SVG element onto a pixmap.
+ * This is a wrapper around a QSvgRenderer, which paints the requested SVG
+ * element onto an image. Requests are rendered on a thread pool of the
+ * provider, so they never block the GUI thread.
+ *
+ * Besides the individual elements, the id "atlas" yields the whole deck in
+ * one image, with a column per rank and a row per suit in the order of
+ * Card::rankIndex and Card::suitIndex, and the back in the first column of a
+ * fifth row. A requested size applies to the whole atlas. Drawing all cards
+ * from the same texture lets the scene graph batch them.
+ *
+ * Rendered images are kept in a least recently used cache keyed by id and
+ * size, so the same image is only rasterised again after it was evicted.
  */
-class CardImageProvider : public QQuickImageProvider
+class CardImageProvider : public QQuickAsyncImageProvider
 {
 public:
+    /// Maximum memory used by the cache, in kilobytes
+    static const int CacheSize = 32 * 1024;
+    static const int AtlasColumns = 8;
+    static const int AtlasRows = 5;
+
     CardImageProvider();
-    QPixmap requestPixmap(const QString& id, QSize* size, const QSize& requestedSize) override;
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+    /// Render synchronously; this is thread safe
+    QImage requestImage(const QString& id, QSize* size, const QSize& requestedSize) override;
 
 private:
+    QSize imageSize(const QSize &naturalSize, const QSize &requestedSize) const;
+    QImage render(const QString &id, const QSize &size);
+    void renderElement(QPainter *painter, const QString &id, const QRectF &bounds);
+
     QSvgRenderer m_renderer;
+    QHash<QString,QSize> m_elementSizes;
+    QCache<QString,QImage> m_cache;
+    QMutex m_cacheMutex;
+    QMutex m_rendererMutex;
+    // Last, so that running requests are waited for before anything they use
+    // is destroyed
+    QThreadPool m_pool;
 };
 
 #endif // CARDIMAGEPROVIDER_H
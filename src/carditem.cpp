@@ -0,0 +1,226 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "carditem.h"
+#include "cardimageprovider.h"
+
+#include <QCoreApplication>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QPointer>
+#include <QQmlEngine>
+#include <QQuickImageProvider>
+#include <QQuickWindow>
+#include <QSGSimpleTextureNode>
+#include <QtConcurrent/QtConcurrentRun>
+
+namespace {
+
+const QString ProviderId = QStringLiteral("cards");
+const QString AtlasId = QStringLiteral("atlas");
+
+// Atlases by height, and the items waiting for one that is still loading.
+// Only used on the GUI thread.
+struct Atlas
+{
+    QImage image;
+    QList<QPointer<CardItem>> waiting;
+};
+
+QHash<int,Atlas> &atlases()
+{
+    static QHash<int,Atlas> atlases;
+    return atlases;
+}
+
+// The texture of an atlas in a window, shared by the nodes that draw it and
+// deleted with the last of them. Nodes live on the render threads.
+struct SharedTexture
+{
+    QSGTexture *texture = nullptr;
+    int nodes = 0;
+};
+
+using TextureKey = QPair<QQuickWindow *,qint64>;
+
+QMutex textureMutex;
+QHash<TextureKey,SharedTexture> textures;
+
+class CardNode : public QSGSimpleTextureNode
+{
+public:
+    CardNode()
+        : m_key(nullptr, 0)
+    {
+        setFiltering(QSGTexture::Linear);
+    }
+
+    ~CardNode() override
+    {
+        QMutexLocker lock(&textureMutex);
+        release();
+    }
+
+    void setAtlas(QQuickWindow *window, const QImage &atlas)
+    {
+        const TextureKey key(window, atlas.cacheKey());
+        if (key == m_key)
+            return;
+        QMutexLocker lock(&textureMutex);
+        auto &shared = textures[key];
+        if (!shared.texture)
+            shared.texture = window->createTextureFromImage(atlas);
+        ++shared.nodes;
+        setTexture(shared.texture);
+        release();
+        m_key = key;
+    }
+
+private:
+    // Give up the current texture; requires the lock
+    void release()
+    {
+        const auto it = textures.find(m_key);
+        if (it == textures.end() || --it->nodes > 0)
+            return;
+        delete it->texture;
+        textures.erase(it);
+    }
+
+    TextureKey m_key;
+};
+
+} // namespace
+
+CardItem::CardItem(QQuickItem *parent)
+    : QQuickItem(parent)
+    , m_column(0)
+    , m_row(0)
+    , m_atlasHeight(0)
+{
+    setFlag(ItemHasContents);
+}
+
+int CardItem::column() const
+{
+    return m_column;
+}
+
+void CardItem::setColumn(int column)
+{
+    if (column == m_column)
+        return;
+    m_column = column;
+    update();
+    emit columnChanged();
+}
+
+int CardItem::row() const
+{
+    return m_row;
+}
+
+void CardItem::setRow(int row)
+{
+    if (row == m_row)
+        return;
+    m_row = row;
+    update();
+    emit rowChanged();
+}
+
+void CardItem::componentComplete()
+{
+    QQuickItem::componentComplete();
+    loadAtlas();
+}
+
+void CardItem::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+    if (newGeometry.height() != oldGeometry.height())
+        loadAtlas();
+    if (newGeometry.size() != oldGeometry.size())
+        update();
+}
+
+QSGNode *CardItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    auto node = static_cast<CardNode *>(oldNode);
+    if (m_atlas.isNull() || width() <= 0 || height() <= 0) {
+        delete node;
+        return nullptr;
+    }
+    if (!node)
+        node = new CardNode;
+    node->setAtlas(window(), m_atlas);
+    const QSizeF cell(qreal(m_atlas.width()) / CardImageProvider::AtlasColumns,
+                      qreal(m_atlas.height()) / CardImageProvider::AtlasRows);
+    node->setSourceRect(QRectF(QPointF(m_column * cell.width(), m_row * cell.height()), cell));
+    node->setRect(boundingRect());
+    return node;
+}
+
+// Use the atlas for the current height, rendering it in the background if no
+// item has done so yet
+void CardItem::loadAtlas()
+{
+    const int atlasHeight = qRound(height()) * CardImageProvider::AtlasRows;
+    if (!isComponentComplete() || atlasHeight <= 0 || atlasHeight == m_atlasHeight)
+        return;
+    m_atlasHeight = atlasHeight;
+    auto &atlas = atlases()[atlasHeight];
+    if (!atlas.image.isNull())
+        return setAtlas(atlas.image);
+    atlas.waiting << this;
+    if (atlas.waiting.size() > 1)
+        return;
+
+    const auto engine = qmlEngine(this);
+    const auto provider = engine ? dynamic_cast<QQuickImageProvider *>(engine->imageProvider(ProviderId)) : nullptr;
+    if (!provider)
+        return;
+    auto watcher = new QFutureWatcher<QImage>(QCoreApplication::instance());
+    connect(watcher, &QFutureWatcherBase::finished, watcher, [watcher, atlasHeight]{
+        auto &atlas = atlases()[atlasHeight];
+        atlas.image = watcher->result();
+        const auto waiting = atlas.waiting;
+        atlas.waiting.clear();
+        for (const auto &item : waiting) {
+            if (item && item->m_atlasHeight == atlasHeight)
+                item->setAtlas(atlas.image);
+        }
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run([provider, atlasHeight]{
+        return provider->requestImage(AtlasId, nullptr, QSize(0, atlasHeight));
+    }));
+}
+
+void CardItem::setAtlas(const QImage &atlas)
+{
+    m_atlas = atlas;
+    setImplicitSize(qreal(atlas.width()) / CardImageProvider::AtlasColumns,
+                    qreal(atlas.height()) / CardImageProvider::AtlasRows);
+    update();
+}
@@ -0,0 +1,72 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef CARDITEM_H
+#define CARDITEM_H
+
+#include <QImage>
+#include <QQuickItem>
+
+/**
+ * A card drawn from the atlas of the "cards" image provider.
+ *
+ * The atlas is loaded in the background once for each card height, and all
+ * cards of that height in a window share a texture of it. Each item draws
+ * only the cell of its card, so there is no clipping and the scene graph can
+ * batch the cards. The cell is chosen by column and row, as described in
+ * CardImageProvider.
+ *
+ * The item needs an explicit height to load the atlas. Its implicit size is
+ * then that of a cell of the loaded atlas.
+ */
+class CardItem : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(int column READ column WRITE setColumn NOTIFY columnChanged)
+    Q_PROPERTY(int row READ row WRITE setRow NOTIFY rowChanged)
+
+public:
+    explicit CardItem(QQuickItem *parent = nullptr);
+
+    int column() const;
+    void setColumn(int column);
+    int row() const;
+    void setRow(int row);
+
+signals:
+    void columnChanged();
+    void rowChanged();
+
+protected:
+    void componentComplete() override;
+    void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+
+private:
+    void loadAtlas();
+    void setAtlas(const QImage &atlas);
+
+    int m_column;
+    int m_row;
+    int m_atlasHeight;
+    QImage m_atlas;
+};
+
+#endif // CARDITEM_H
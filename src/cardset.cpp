@@ -19,6 +19,7 @@
 
 #include "cardset.h"
 #include "rules.h"
+#include "runtable.h"
 
 #include <QVariantList>
 #include <QList>
@@ -74,6 +75,7 @@ void CardSet::append(const Card &card)
     QVector::append(card);
     m_suitSets[card.suit()] << card;
     ++m_suitCounts[card.suit()];
+    m_suitMasks[Card::suitIndex(card.suit())] |= 1 << Card::rankIndex(card.rank());
 }
 
 void CardSet::append(const CardSet &set)
@@ -94,12 +96,24 @@ CardSet &CardSet::operator<<(const CardSet &set)
     return *this;
 }
 
+void CardSet::insert(int i, const Card &card)
+{
+    const auto suitPosition = std::count_if(cbegin(), cbegin() + i, [&](const Card &c) {
+        return c.suit() == card.suit();
+    });
+    QVector::insert(i, card);
+    m_suitSets[card.suit()].insert(int(suitPosition), card);
+    ++m_suitCounts[card.suit()];
+    m_suitMasks[Card::suitIndex(card.suit())] |= 1 << Card::rankIndex(card.rank());
+}
+
 void CardSet::remove(const Card &card)
 {
     m_suitSets[card.suit()].removeOne(card);
     if (m_suitSets[card.suit()].isEmpty())
         m_suitSets.remove(card.suit());
     --m_suitCounts[card.suit()];
+    m_suitMasks[Card::suitIndex(card.suit())] &= ~(1 << Card::rankIndex(card.rank()));
     const bool removed = removeOne(card);
     Q_ASSERT(removed);
 }
@@ -108,6 +122,7 @@ void CardSet::clear()
 {
     m_suitSets.clear();
     m_suitCounts.clear();
+    m_suitMasks.fill(0);
     QVector::clear();
 }
 
@@ -127,52 +142,60 @@ QMap<Card::Suit, int> CardSet::cardsPerSuit(const QVector<Card::Suit> suits) con
     return m_suitCounts;
 }
 
+uchar CardSet::suitMask(Card::Suit suit) const
+{
+    return m_suitMasks[Card::suitIndex(suit)];
+}
+
+quint32 CardSet::mask() const
+{
+    quint32 mask = 0;
+    for (int s = 0; s < 4; ++s)
+        mask |= quint32(m_suitMasks[s]) << (8 * s);
+    return mask;
+}
+
 /* Compute the run lengths for each suit of cards.
  *
  * The run length is defined as the number of successive high cards. It is an
- * important characteristic in determining the strength of one's hand.
+ * important characteristic in determining the strength of one's hand. The runs
+ * are looked up by each suit's rank mask in the precomputed run tables.
  */
-CardSet::RunMap CardSet::runs(const SortingMap sortingMap) const
+CardSet::RunMap CardSet::runs(Card::Suit trumpSuit) const
 {
     RunMap runs;
-    for (auto set = m_suitSets.begin(); set != m_suitSets.end(); ++set) {
-        auto suit = set.key();
-        auto cards = set.value();
-        const auto order = sortingMap.value(suit);
-        sort(cards, order);
-        const auto firstRank = cards.first().rank();
-        if (order[firstRank] != 7)
+    for (const auto suit : Card::Suits) {
+        const bool isTrump = suit == trumpSuit;
+        const auto length = runTable(isTrump)[suitMask(suit)].topRun;
+        if (length == 0)
             continue;
-        runs.insert(suit, {firstRank});
-        for (auto c = cards.cbegin() + 1; c < cards.cend() && order[(c - 1)->rank()] - order[c->rank()] == 1; ++c)
-            runs[suit].append(c->rank());
+        const auto &sequence = rankSequence(isTrump);
+        auto &run = runs[suit];
+        for (int i = 0; i < length; ++i)
+            run << sequence[i];
     }
     return runs;
 }
 
-QMap<Card::Suit,int> CardSet::maxRunLengths(const SortingMap sortingMap) const
+QMap<Card::Suit,int> CardSet::maxRunLengths(Card::Suit trumpSuit) const
 {
     QMap<Card::Suit,int> runLengths;
-
-    for (auto set = m_suitSets.begin(); set != m_suitSets.end(); ++set) {
-        auto suit = set.key();
-        auto cards = set.value();
-
-        auto order = sortingMap[suit];
-        sort(cards, order);
-        int currentLength = 1;
-
-        for (auto c = cards.cbegin(); c < cards.cend() - 1; ++c) {
-            if (order[c->rank()] - order[(c + 1)->rank()] == 1)
-                ++currentLength;
-            else
-                currentLength = 1;
-        }
-        runLengths[suit] = currentLength;
+    for (const auto suit : Card::Suits) {
+        const auto mask = suitMask(suit);
+        if (mask != 0)
+            runLengths[suit] = runTable(suit == trumpSuit)[mask].maxRun;
     }
     return runLengths;
 }
 
+int CardSet::runStrength(Card::Suit trumpSuit) const
+{
+    int strength = 0;
+    for (const auto suit : Card::Suits)
+        strength += runTable(suit == trumpSuit)[suitMask(suit)].topRunValue;
+    return strength;
+}
+
 int CardSet::score(const Card::Suit trumpSuit) const
 {
     int score = 0;
@@ -26,13 +26,14 @@
 #include <QVector>
 #include <QMap>
 
+#include <array>
+
 class CardSet : public QVector<Card>
 {
     Q_GADGET
     Q_PROPERTY(QVariantList cards READ cards)
 
 public:
-    using SortingMap = QMap<Card::Suit,Card::Order>;
     using RunMap = QMap<Card::Suit,QVector<Card::Rank>>;
     enum class SuitOrder : char {
         Alternating,
@@ -54,20 +55,29 @@ public:
     bool containsSuit(const Card::Suit suit) const;
     const QMap<Card::Suit, QVector<Card>> &suitSets() const;
     QMap<Card::Suit,int> cardsPerSuit(const QVector<Card::Suit> suits = Card::Suits) const;
-    RunMap runs(const SortingMap sortingMap) const;
-    QMap<Card::Suit,int> maxRunLengths(const SortingMap sortingMap) const;
+    RunMap runs(Card::Suit trumpSuit) const;
+    QMap<Card::Suit,int> maxRunLengths(Card::Suit trumpSuit) const;
+    /// The summed values of the top runs in all suits
+    int runStrength(Card::Suit trumpSuit) const;
+    /// The ranks held in the given suit, as a mask of Card::rankIndex bits
+    uchar suitMask(Card::Suit suit) const;
+    /// All cards held, as a mask of Card::id bits
+    quint32 mask() const;
     int score(Card::Suit trumpSuit) const;
 
     /// Sort all cards in plain ranks
     void sortAll();
     /// Sort with trump ranks
     void sortAll(SuitOrder suitOrder, Card::Suit trumpSuit);
+    /// Insert the card at position i, as if it had never been removed
+    void insert(int i, const Card &card);
     void remove(const Card &card);
     void clear();
 
 private:
     QMap<Card::Suit,QVector<Card>> m_suitSets;
     QMap<Card::Suit,int> m_suitCounts;
+    std::array<uchar,4> m_suitMasks {};
 };
 
 #endif // CARDSET_H
@@ -23,6 +23,7 @@
 #include "players/aiplayer.h"
 #include "players/randomplayer.h"
 #include "team.h"
+#include "trace.h"
 
 #include <QString>
 #include <QStringList>
@@ -38,29 +39,25 @@ using Suit = Card::Suit;
 using Rank = Card::Rank;
 const QStringList DefaultNames {"South", "West", "North", "East"};
 
-QVariantList bidOptions(const QVector<Suit> suits = Card::Suits) {
-    QVariantList options;
-    for (const auto &s : suits)
-        options << QVariant::fromValue(s);
-    return options;
-}
-
 }
 
 Game::Game(QObject *parent, int numRounds)
     : QObject(parent)
     , m_engine(nullptr)
+    , m_awaiting{nullptr, DecisionType::Bid}
     , m_contractors(nullptr)
     , m_defenders(nullptr)
     , m_human(nullptr)
-    , m_bidCounter(0)
     , m_turn(0)
     , m_round(0)
     , m_numRounds(numRounds)
     , m_trumpRule(TrumpRule::Amsterdams)
-    , m_bidRule(BidRule::Random)
-    , m_biddingPhase(true)
+    , m_bidding(BidRule::Random)
+    , m_random(std::random_device()())
+    , m_phase(Phase::Bidding)
     , m_status(Ready)
+    , m_isAwaiting(false)
+    , m_isDispatching(false)
 {
     // Reserve vector space
     m_deck.reserve(32);
@@ -80,6 +77,8 @@ void Game::addPlayer(Player *player)
     if (m_players.size() <= 4) {
         connect(this, &Game::newRound, player, &Player::bidSort);
         connect(this, &Game::newContract, player, &Player::playSort);
+        connect(player, &Player::bidSelected, this, &Game::acceptBid);
+        connect(player, &Player::moveSelected, this, &Game::acceptMove);
         auto human = dynamic_cast<HumanPlayer*>(player);
         if (human)
             m_human = human;
@@ -197,13 +196,14 @@ void Game::start()
     m_dealer = dynamic_cast<Player*>(m_players.at(1).get());
     m_eldest = nextPlayer(m_dealer);
     m_currentPlayer = m_eldest;
+    m_bidding.start(m_round == 0);
     deal();
     emit newRound();
 }
 
 void Game::deal()
 {
-    std::random_shuffle(m_deck.begin(), m_deck.end());
+    std::shuffle(m_deck.begin(), m_deck.end(), m_random);
     for (int i = 0; i < m_players.size(); ++i)
         m_players[i]->setHand(m_deck.mid(i*8, 8));
 }
@@ -212,18 +212,22 @@ void Game::restart()
 {
     m_round = 0;
     m_turn = 0;
+    m_phase = Phase::Bidding;
+    m_requests.clear();
+    m_decisions.clear();
+    m_isAwaiting = false;
     m_roundCards.clear();
     for (auto t : m_teams)
         t->resetScore();
+    setStatus(Ready);
     start();
 }
 
 /** Advance the state of the current game.
  *
- * This slot controls the state of an interactive game, which must be able to
- * wait for player input. It sets the waiting flag to true when expecting a
- * signal from a player, blocking further calls until this flag is reset by the
- * acceptBid or acceptMove slots.
+ * This slot resumes an interactive game that has paused in the Ready status.
+ * It starts the next step of the current phase and dispatches the resulting
+ * requests; the status remains Waiting until the game reaches its next pause.
  */
 void Game::advance()
 {
@@ -231,91 +235,102 @@ void Game::advance()
     if (m_status != Ready)
         return;
 
-    if (m_biddingPhase) {
-        setStatus(Waiting);
+    setStatus(Waiting);
+    switch (m_phase) {
+    case Phase::Bidding:
         proposeBid();
-    } else if (m_turn == 4) {
-        // Trick complete
-        m_turn = 0;
-        const auto trick = const_cast<const GameEngine*>(m_engine.get())->currentTrick();
-        qCDebug(klaverjasGame) << "Current trick:" << trick;
-        qCDebug(klaverjasGame) << "Trick winner:" << m_currentPlayer << "Points:" << trick.score().sum();
-        advance();
-    } else if (!m_engine->isFinished()) {
-        handleTrick();
-    } else if (m_round < m_numRounds) {
-        // One round (game) completed
-        handleRound();
-    } else {
-        setStatus(Finished);
-        qCInfo(klaverjasGame) << "Game finished";
+        break;
+    case Phase::Playing:
+        if (m_engine->isFinished()) {
+            handleRound();
+            return;
+        }
+        if (m_turn == 0)
+            emit newTrick();
+        request(DecisionType::Move);
+        break;
+    case Phase::Finished:
+        return;
     }
+    dispatch();
 }
 
-void Game::proposeBid()
+/* Pass queued requests on to the players and apply their decisions, until a
+ * decision is needed that will only be made later. Decisions made during this
+ * loop are queued by acceptBid and acceptMove, which then return to it.
+ */
+void Game::dispatch()
 {
-    const auto allOptions = bidOptions();
-    if (m_bidCounter == 0) {
-        m_bidOptions = initialBidOptions();
-        emit biddingStarted();
-    } else if (m_bidCounter % 4 == 0)
-        // All players have passed in the first round of bidding.
-        refineBidOptions();
-    ++m_bidCounter;
-    connect(this, &Game::bidRequested, m_currentPlayer, &Player::selectBid);
-    connect(m_currentPlayer, &Player::bidSelected, this, &Game::acceptBid);
-    qCDebug(klaverjasGame) << "Requesting a bid";
-    emit bidRequested(m_bidOptions, m_currentPlayer);
-}
-
-QVariantList Game::initialBidOptions() const
-{
-    const auto allOptions = bidOptions();
-    switch (m_bidRule) {
-    case BidRule::Official:
-        return {allOptions, QVariant()};
-    case BidRule::Utrechts:
-        return allOptions;
-    default:
-        // For Random and Twents games, the first choice in a game is Clubs,
-        // otherwise a random suit is chosen.
-        if (m_round == 0)
-            return bidOptions({Suit::Clubs}) << QVariant();
-        else
-            return {allOptions[std::rand() % 4], QVariant()};
+    if (m_isDispatching)
+        return;
+    KLAVERJAS_TRACE("game", "Game::dispatch");
+    m_isDispatching = true;
+    while (!m_decisions.isEmpty() || !m_requests.isEmpty()) {
+        if (!m_decisions.isEmpty()) {
+            const auto decision = m_decisions.dequeue();
+            if (decision.type == DecisionType::Bid)
+                applyBid(decision.bid);
+            else
+                applyMove(decision.move);
+            continue;
+        }
+        m_awaiting = m_requests.dequeue();
+        m_isAwaiting = true;
+        if (m_awaiting.type == DecisionType::Bid) {
+            qCDebug(klaverjasGame) << "Requesting a bid";
+            emit bidRequested(m_bidOptions, m_awaiting.player);
+            m_awaiting.player->selectBid(m_bidOptions);
+        } else {
+            const auto moves = m_engine->validMoves();
+            emit moveRequested(moves);
+            m_awaiting.player->selectMove(moves);
+        }
     }
+    m_isDispatching = false;
 }
 
-void Game::refineBidOptions()
+void Game::request(DecisionType type)
 {
-    Q_ASSERT(m_bidRule != BidRule::Utrechts);
-    const auto allOptions = bidOptions();
-    if (m_bidRule == BidRule::Random) {
-        auto forbidden = m_bidOptions.first();
-        m_bidOptions.clear();
-        for (const auto bid : allOptions) {
-            if (bid != forbidden)
-                m_bidOptions << bid;
-        }
-    } else if (m_bidRule == BidRule::Official)
-        m_bidOptions.removeLast();
+    m_requests.enqueue({m_currentPlayer, type});
+}
+
+bool Game::isAwaiting(const QObject *player, DecisionType type) const
+{
+    return m_isAwaiting && m_awaiting.type == type && m_awaiting.player == player;
+}
+
+void Game::proposeBid()
+{
+    if (m_bidding.isStarting()) {
+        m_belief = Belief();
+        emit biddingStarted();
+    }
+    m_bidOptions = m_bidding.next(m_random);
+    if (m_bidOptions.isEmpty())
+        applyBid(QVariant::fromValue(m_bidding.drawnSuit()));
     else
-        acceptBid(allOptions[std::rand() % 4]);
+        request(DecisionType::Bid);
 }
 
 void Game::acceptBid(QVariant bid)
 {
-    if (!m_biddingPhase)
+    if (!isAwaiting(sender(), DecisionType::Bid))
         return;
-    disconnect(this, &Game::bidRequested, 0, 0);
-    disconnect(m_currentPlayer, &Player::bidSelected, 0, 0);
+    m_isAwaiting = false;
+    m_decisions.enqueue({DecisionType::Bid, bid, Card()});
+    dispatch();
+}
+
+void Game::applyBid(const QVariant &bid)
+{
+    KLAVERJAS_TRACE("game", "Game::applyBid");
+    m_belief.observeBid(uint(playerIndex(m_currentPlayer)), m_bidOptions, bid);
     if (bid.isNull()) {
         qCDebug(klaverjasGame) << "Player" << m_currentPlayer << "passed";
         advancePlayer(m_currentPlayer);
         proposeBid();
     } else {
-        m_biddingPhase = false;
-        m_bidCounter = 0;
+        m_phase = Phase::Playing;
         setContract(bid.value<Card::Suit>(), m_currentPlayer);
         setStatus(Ready);
     }
@@ -334,49 +349,57 @@ void Game::setContract(const Card::Suit suit, const Player *player)
         m_engine->reset(currentPos, contractorPos, m_trumpSuit);
     else
         m_engine = GameEngine::create(m_players, currentPos, contractorPos, m_trumpRule, m_trumpSuit);
+    if (m_engine)
+        m_engine->setBelief(std::make_shared<const Belief>(m_belief), Belief::Samples);
     emit newContract(suit, m_contractors);
 }
 
-void Game::handleTrick()
+void Game::acceptMove(Card card)
 {
-    if (m_turn == 0) {
-        emit newTrick();
-    }
-    connect(this, &Game::moveRequested, m_currentPlayer, &Player::selectMove);
-    connect(m_currentPlayer, &Player::moveSelected, this, &Game::acceptMove);
-    setStatus(Waiting);
-    emit moveRequested(m_engine->validMoves());
+    if (!isAwaiting(sender(), DecisionType::Move))
+        return;
+    m_isAwaiting = false;
+    m_decisions.enqueue({DecisionType::Move, QVariant(), card});
+    dispatch();
 }
 
-void Game::acceptMove(Card card)
+void Game::applyMove(const Card &card)
 {
-    if (m_status != Waiting || m_biddingPhase)
-        return;
-    disconnect(this, &Game::moveRequested, 0, 0);
-    disconnect(m_currentPlayer, &Player::moveSelected, this, &Game::acceptMove);
+    KLAVERJAS_TRACE("game", "Game::applyMove");
     qCDebug(klaverjasGame) << m_currentPlayer << "played" << card;
     emit cardPlayed(currentPlayer(), card);
     m_engine->doMove(card);
     m_currentPlayer = playerAt(m_engine->currentPlayer());
-    setStatus(Ready);
-    ++m_turn;
-    if (m_turn < 4)
-        advance();
+    if (++m_turn < 4) {
+        request(DecisionType::Move);
+    } else {
+        // Trick complete
+        m_turn = 0;
+        qCDebug(klaverjasGame) << "Trick winner:" << m_currentPlayer << "Scores:" << m_engine->scores();
+        setStatus(Ready);
+    }
 }
 
 void Game::handleRound()
 {
+    KLAVERJAS_TRACE("game", "Game::handleRound");
     m_roundCards << m_engine->cardsPlayed();
     const auto scores = m_engine->scores();
     for (int i : {0, 1})
         m_teams[i]->addPoints(scores[i]);
     qCInfo(klaverjasGame) << "Round scores: " << scores;
     m_turn = 0;
-    ++m_round;
+    if (++m_round == m_numRounds) {
+        m_phase = Phase::Finished;
+        setStatus(Finished);
+        qCInfo(klaverjasGame) << "Game finished";
+        return;
+    }
     advancePlayer(m_dealer);
     advancePlayer(m_eldest);
     m_currentPlayer = m_eldest;
-    m_biddingPhase = true;
+    m_phase = Phase::Bidding;
+    m_bidding.start(false);
     deal();
     setStatus(Ready);
     emit newRound();
@@ -23,10 +23,13 @@
 #include "rules.h"
 #include "card.h"
 #include "gameengine.h"
+#include "bidding.h"
+#include "belief.h"
 
 #include <QObject>
 #include <QVector>
 #include <QMap>
+#include <QQueue>
 #include <QQmlListProperty>
 #include <QVariantList>
 
@@ -38,6 +41,22 @@ class Player;
 class HumanPlayer;
 class Team;
 
+/**
+ * Interactive game of klaverjas.
+ *
+ * The Game is a state machine that moves through the bidding and playing
+ * phases of each round. Whenever it needs a bid or move it queues a request
+ * for the current player, which is passed on by dispatch(). Players reply
+ * through their bidSelected and moveSelected signals, which are connected
+ * once when they join the game. A reply that arrives while the requests are
+ * being dispatched, as it does for the AI players, is queued as well and
+ * handled by the same loop, so the stack depth does not grow with the number
+ * of moves. A reply that arrives later, e.g. from the user interface, starts
+ * a new dispatch loop.
+ *
+ * The game pauses in the Ready status after each contract, trick and round
+ * until advance() is called.
+ */
 class Game : public QObject
 {
     Q_OBJECT
@@ -96,12 +115,28 @@ private slots:
     void acceptMove(Card card);
 
 private:
+    enum class Phase { Bidding, Playing, Finished };
+    enum class DecisionType { Bid, Move };
+    struct Request
+    {
+        Player *player;
+        DecisionType type;
+    };
+    struct Decision
+    {
+        DecisionType type;
+        QVariant bid;
+        Card move;
+    };
+
+    void dispatch();
+    void request(DecisionType type);
+    bool isAwaiting(const QObject *player, DecisionType type) const;
+    void applyBid(const QVariant &bid);
+    void applyMove(const Card &card);
     void deal();
     void proposeBid();
-    QVariantList initialBidOptions() const;
-    void refineBidOptions();
     void setContract(const Card::Suit suit, const Player *player);
-    void handleTrick();
     void handleRound();
     void setStatus(Status newStatus);
 
@@ -109,6 +144,9 @@ private:
     void advancePlayer(Player *&player) const;
 
     std::unique_ptr<GameEngine> m_engine;
+    QQueue<Request> m_requests;
+    QQueue<Decision> m_decisions;
+    Request m_awaiting;
     QVariantList m_bidOptions;
     QVector<Card> m_deck;
     QVector<QVector<Card>> m_roundCards;
@@ -120,15 +158,19 @@ private:
     Team *m_contractors;
     Team *m_defenders;
     HumanPlayer *m_human;
-    int m_bidCounter;
     int m_turn;
     int m_round;
     int m_numRounds;
     TrumpRule m_trumpRule;
-    BidRule m_bidRule;
+    Bidding m_bidding;
+    std::mt19937 m_random;
+    // What the bids of this round revealed about the players' hands
+    Belief m_belief;
     Card::Suit m_trumpSuit;
-    bool m_biddingPhase;
+    Phase m_phase;
     Status m_status;
+    bool m_isAwaiting;
+    bool m_isDispatching;
 };
 
 #endif // GAME_H
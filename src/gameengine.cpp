@@ -18,12 +18,20 @@
  */
 
 #include "gameengine.h"
+#include "belief.h"
+#include "suitpermutation.h"
+#include "trace.h"
+#include "valuefunction.h"
 #include "players/baseplayer.h"
 
 #include <QMap>
 #include <QSet>
+#include <QtAlgorithms>
 
 #include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
 
 namespace {
 
@@ -45,14 +53,23 @@ inline ushort team(GameEngine::Position position)
     return ushort(position) % 2;
 }
 
-inline std::vector<Card> higherCards(const QVector<Card> cards, Card toBeat, const Card::Order order)
+// The ranks at least as high as the given one, as a mask of Card::rankIndex bits
+template<bool IsTrump>
+inline uchar higherRanks(Rank toBeat)
 {
-    std::vector<Card> result;
-    result.reserve(cards.size());
-    for (const auto &c : cards)
-        if (c.suit() == toBeat.suit() && order[c.rank()] >= order[toBeat.rank()])
-            result.emplace_back(c);
-    return result;
+    const auto &ranks = IsTrump ? TrumpRanking : PlainRanking;
+    const auto minimum = ranks[Card::rankIndex(toBeat)];
+    uchar mask = 0;
+    for (uint i = 0; i < 8; ++i) {
+        if (ranks[i] >= minimum)
+            mask |= 1 << i;
+    }
+    return mask;
+}
+
+inline quint32 suitBits(Suit suit)
+{
+    return quint32(0xff) << (8 * Card::suitIndex(suit));
 }
 
 CIter highestInPlainSuit(QVector<Card> &cards, Suit suit)
@@ -67,6 +84,28 @@ CIter highestInPlainSuit(QVector<Card> &cards, Suit suit)
     return top ? top : cards.end();
 }
 
+// Convert a mask of Card::rankIndex bits to one of BonusOrder positions
+uchar sequenceMask(uchar rankMask)
+{
+    uchar mask = 0;
+    for (const auto rank : Card::Ranks) {
+        if (rankMask & (1 << Card::rankIndex(rank)))
+            mask |= 1 << BonusOrder[rank];
+    }
+    return mask;
+}
+
+// The bonus for the longest run in a trick's cards of one suit
+int runBonus(uchar sequenceMask)
+{
+    int longest = 0;
+    for (int length = 0; sequenceMask; sequenceMask >>= 1) {
+        length = sequenceMask & 1 ? length + 1 : 0;
+        longest = std::max(longest, length);
+    }
+    return longest >= 4 ? 50 : longest == 3 ? 20 : 0;
+}
+
 template<typename T> inline GameEngine::Position operator+(GameEngine::Position p, T t)
 {
     return p += t;
@@ -94,6 +133,16 @@ GameEngine::GameEngine(const PlayerList players, Position firstPlayer, Position
     , m_currentPlayer(firstPlayer)
     , m_contractor(contractor)
     , m_isMarch(true)
+    , m_mergeEquivalentMoves(false)
+    , m_earlyTermination(false)
+    , m_terminationFloor(0)
+    , m_playoutTricks(0)
+    , m_rootTricks(0)
+    , m_beliefSamples(0)
+    , m_undoSize(0)
+    , m_legalMoves(trumpRule == TrumpRule::Amsterdams
+        ? &GameEngine::legalMoves<TrumpRule::Amsterdams>
+        : &GameEngine::legalMoves<TrumpRule::Rotterdams>)
 {
     m_tricks.reserve(8);
     setDefaultConstraints();
@@ -119,20 +168,39 @@ GameEngine::GameEngine(const GameEngine& other)
         m_players << clone;
         m_playerConstraints.insert(clone, other.m_playerConstraints.value(p));
     }
+    m_undoSize = 0;
+}
+
+std::unique_ptr<GameEngine> GameEngine::clone() const
+{
+    return std::unique_ptr<GameEngine>(new GameEngine(*this));
 }
 
 GameEngine::Ptr GameEngine::cloneAndRandomise(uint observer) const
 {
+    return Ptr(determinisedClone(observer).release());
+}
+
+// Each thread of the library solver gets a generator of its own
+std::unique_ptr<GameEngine> GameEngine::determinisedClone(uint observer) const
+{
+    thread_local std::mt19937 random(std::random_device{}());
+    return determinisedClone(observer, random);
+}
+
+std::unique_ptr<GameEngine> GameEngine::determinisedClone(uint observer, std::mt19937 &random) const
+{
+    KLAVERJAS_TRACE("engine", "GameEngine::cloneAndRandomise");
     auto clone = new GameEngine(*this);
-    clone->determiniseCards(observer);
-    return Ptr(clone);
+    clone->determiniseCards(observer, random);
+    return std::unique_ptr<GameEngine>(clone);
 }
 
 /* Observer has seen his own cards as well as all cards played up to this
  * point, so collect the other players' hands and randomly deal them the same
  * number of new cards
  */
-void GameEngine::determiniseCards(uint observer) const
+void GameEngine::determiniseCards(uint observer, std::mt19937 &random) const
 {
     QVector<Player> others;
     QVector<Card> unknowns;
@@ -156,17 +224,62 @@ void GameEngine::determiniseCards(uint observer) const
     std::sort(others.begin(), others.end(), [&](Player p1, Player p2) {
         return constraintSum(m_playerConstraints.value(p1)) < constraintSum(m_playerConstraints.value(p2));
     });
-    constrainedDeal(others, unknowns);
+    constrainedDeal(others, unknowns, random);
+    if (!m_belief || m_beliefSamples < 2)
+        return;
+
+    // Keep one of the sampled deals with a probability proportional to its
+    // weight, replacing the kept deal by each new one in turn. The weights
+    // are products of up to 24 factors, so they are summed as logarithms.
+    QVector<CardSet> kept;
+    for (const auto &player : qAsConst(others))
+        kept << player->hand();
+    std::uniform_real_distribution<qreal> uniform;
+    qreal logTotal = dealLogWeight(observer);
+    for (int i = 1; i < m_beliefSamples; ++i) {
+        constrainedDeal(others, unknowns, random);
+        const auto logWeight = dealLogWeight(observer);
+        const auto high = std::max(logTotal, logWeight);
+        logTotal = high + std::log(std::exp(logTotal - high) + std::exp(logWeight - high));
+        if (uniform(random) < std::exp(logWeight - logTotal)) {
+            for (int p = 0; p < others.size(); ++p)
+                kept[p] = others[p]->hand();
+        }
+    }
+    for (int p = 0; p < others.size(); ++p)
+        others[p]->setHand(kept[p]);
+}
+
+qreal GameEngine::dealWeight(uint observer) const
+{
+    return std::exp(dealLogWeight(observer));
 }
 
-void GameEngine::constrainedDeal(const GameEngine::PlayerList players, const QVector<Card> cards) const
+qreal GameEngine::dealLogWeight(uint observer) const
+{
+    if (!m_belief)
+        return 0;
+    qreal logWeight = 0;
+    for (uint p = 0; p < 4; ++p) {
+        if (p == observer)
+            continue;
+        const auto &signals = m_playerSignals.at(p);
+        for (const auto &card : m_players[p]->hand()) {
+            const auto signal = signals.value(card.suit(), Trick::Signal::None);
+            logWeight += std::log(m_belief->weight(p, card) * Belief::signalWeight(card, signal));
+        }
+    }
+    return logWeight;
+}
+
+void GameEngine::constrainedDeal(const GameEngine::PlayerList players, const QVector<Card> cards, std::mt19937 &random) const
 {
     bool deal = false;
     int dealCounter = 1;
     QVector<Card> newHands(cards.size());
     while (!deal && dealCounter < 1000) {
         QVector<Card> shuffled(cards);
-        std::random_shuffle(shuffled.begin(), shuffled.end());
+        std::shuffle(shuffled.begin(), shuffled.end(), random);
         for (const auto &player : players) {
             auto i = shuffled.size() - 1;
             auto target = newHands.begin();
@@ -241,40 +354,242 @@ uint GameEngine::currentPlayer() const
 
 std::vector<Card> GameEngine::validMoves() const
 {
-    const auto currentHand = m_players[currentPlayer()]->hand();
+    std::vector<Card> moves;
+    for (auto mask = validMoveMask(); mask; mask &= mask - 1)
+        moves.push_back(Card::fromId(qCountTrailingZeroBits(mask)));
+    return moves;
+}
+
+// Merging keeps the lowest card of each equivalence class
+quint32 GameEngine::validMoveMask() const
+{
+    if (isCutShort())
+        return 0;
+    const auto moves = (this->*m_legalMoves)();
+    if (!m_mergeEquivalentMoves || (moves & (moves - 1)) == 0)
+        return moves;
+    const auto open = openCards();
+    quint32 merged = 0;
+    for (auto rest = moves; rest; rest &= rest - 1) {
+        const auto move = Card::fromId(qCountTrailingZeroBits(rest));
+        bool isNew = true;
+        for (auto kept = merged; kept && isNew; kept &= kept - 1)
+            isNew = !areEquivalent(Card::fromId(qCountTrailingZeroBits(kept)), move, open);
+        if (isNew)
+            merged |= rest & ~(rest - 1);
+    }
+    return merged;
+}
+
+template<TrumpRule Rule>
+quint32 GameEngine::legalMoves() const
+{
+    const auto &currentHand = m_players[currentPlayer()]->hand();
+    const auto hand = currentHand.mask();
     const auto currentPos = currentTrick().cards().size();
-    // minimumRank returns empty if all moves are valid
-    const auto minRank = minimumRank(currentHand, currentPos);
-    if (minRank.isEmpty())
-        return currentHand.toStdVector();
-
-    const auto order = rankOrder(minRank[0].suit() == m_trumpSuit);
-    auto moves = higherCards(currentHand, minRank[0], order);
-    if (!moves.empty())
+    Card minRank;
+    if (!minimumRank<Rule>(currentHand, currentPos, &minRank))
+        return hand;
+
+    const quint32 higher = minRank.suit() == m_trumpSuit
+        ? higherRanks<true>(minRank.rank())
+        : higherRanks<false>(minRank.rank());
+    const quint32 moves = hand & (higher << (8 * Card::suitIndex(minRank.suit())));
+    if (moves)
         return moves;
 
     // If there are still no valid moves at this point, it means the player has
     // to beat a trump card but can't, leading to two possibilities
-    setConstraint(currentPlayer(), m_trumpSuit, minRank[0].rank());
+    setConstraint(currentPlayer(), m_trumpSuit, minRank.rank());
+    const auto trumps = hand & suitBits(m_trumpSuit);
     const auto trumpsLed = currentTrick().suitLed() == m_trumpSuit;
-    const auto hasOnlyTrumps = currentHand.suitSets().size() == 1 && currentHand.containsSuit(m_trumpSuit);
+    const auto hasOnlyTrumps = trumps && trumps == hand;
     if (trumpsLed || hasOnlyTrumps) {
         // Player may play a lower trump
-        moves = higherCards(currentHand, {m_trumpSuit, Rank::Seven}, TrumpOrder);
         if (!trumpsLed)
             // Being forced to play trumps in this case reveals the lack of
             // other suits to other players
             for (const auto &suit : Card::Suits)
                 if (suit != m_trumpSuit)
                     removeConstraint(currentPlayer(), suit);
-    } else {
-        // Player has other suits available and must play from these
-        for (const auto &set : currentHand.suitSets())
-            if (set.first().suit() != m_trumpSuit)
-                moves.insert(moves.end(), set.begin(), set.end());
+        Q_ASSERT(trumps);
+        return trumps;
     }
-    Q_ASSERT(!moves.empty());
-    return moves;
+    // Player has other suits available and must play from these
+    Q_ASSERT(hand & ~trumps);
+    return hand & ~trumps;
+}
+
+/* Two cards of the current player are interchangeable if they are worth the
+ * same points and compare the same with every card they may still meet in a
+ * trick, i.e. the cards in other hands and the current trick. They must also
+ * complete the same runs with any of those cards, and neither may be part of a
+ * possible four of a kind. Swapping them throughout the rest of the game then
+ * leaves every score unchanged.
+ */
+bool GameEngine::areEquivalent(Card a, Card b) const
+{
+    return areEquivalent(a, b, openCards());
+}
+
+bool GameEngine::areEquivalent(Card a, Card b, const SuitMasks &open) const
+{
+    if (a == b)
+        return true;
+    if (a.suit() != b.suit())
+        return false;
+    const bool isTrump = a.suit() == m_trumpSuit;
+    const auto &values = cardValues(isTrump);
+    if (values[a.rank()] != values[b.rank()])
+        return false;
+
+    const auto suitOpen = open[Card::suitIndex(a.suit())];
+    const auto &order = rankOrder(isTrump);
+    const auto low = std::min(order[a.rank()], order[b.rank()]);
+    const auto high = std::max(order[a.rank()], order[b.rank()]);
+    for (const auto rank : Card::Ranks) {
+        if ((suitOpen & (1 << Card::rankIndex(rank))) && order[rank] > low && order[rank] < high)
+            return false;
+    }
+
+    const auto fourPossible = [&](Rank rank) {
+        for (const auto suit : Card::Suits) {
+            if (suit != a.suit() && !(open[Card::suitIndex(suit)] & (1 << Card::rankIndex(rank))))
+                return false;
+        }
+        return true;
+    };
+    if (fourPossible(a.rank()) || fourPossible(b.rank()))
+        return false;
+
+    // Try every set of up to three other cards of the suit
+    const uchar sequenceOpen = sequenceMask(suitOpen);
+    const uchar sequenceA = 1 << BonusOrder[a.rank()];
+    const uchar sequenceB = 1 << BonusOrder[b.rank()];
+    for (uchar others = sequenceOpen; ; others = (others - 1) & sequenceOpen) {
+        if (std::bitset<8>(others).count() <= 3 && runBonus(others | sequenceA) != runBonus(others | sequenceB))
+            return false;
+        if (others == 0)
+            break;
+    }
+    return true;
+}
+
+std::vector<std::vector<Card>> GameEngine::equivalenceClasses(const std::vector<Card> &moves) const
+{
+    const auto open = openCards();
+    std::vector<std::vector<Card>> classes;
+    for (const auto &move : moves) {
+        const auto match = std::find_if(classes.begin(), classes.end(), [&](const std::vector<Card> &c) {
+            return areEquivalent(c.front(), move, open);
+        });
+        if (match == classes.end())
+            classes.push_back({move});
+        else
+            match->push_back(move);
+    }
+    return classes;
+}
+
+void GameEngine::setMergeEquivalentMoves(bool merge)
+{
+    m_mergeEquivalentMoves = merge;
+}
+
+void GameEngine::setEarlyTermination(bool enabled)
+{
+    m_earlyTermination = enabled;
+    m_terminationFloor = cardsPlayedCount();
+}
+
+bool GameEngine::isDecided() const
+{
+    if (isFinished())
+        return true;
+    const auto contractors = team(m_contractor);
+    const int contractorScore = m_scores[contractors].sum();
+    const int defenderScore = m_scores[1 - contractors].sum();
+    const int remaining = remainingPoints(true);
+    if (contractorScore + remaining <= defenderScore)
+        return true;
+    return contractorScore > defenderScore + remaining && !m_isMarch;
+}
+
+void GameEngine::setValueFunction(std::shared_ptr<const ValueFunction> function, int playoutTricks)
+{
+    m_valueFunction = std::move(function);
+    m_playoutTricks = playoutTricks;
+    m_rootTricks = tricksPlayed();
+    m_terminationFloor = cardsPlayedCount();
+}
+
+void GameEngine::setBelief(std::shared_ptr<const Belief> belief, int samples)
+{
+    m_belief = std::move(belief);
+    m_beliefSamples = samples;
+}
+
+bool GameEngine::isCutShort() const
+{
+    if (isFinished() || cardsPlayedCount() <= m_terminationFloor)
+        return false;
+    return (m_earlyTermination && isDecided()) || isTruncated();
+}
+
+// Playouts are only truncated between tricks, which is where the value
+// function is fitted
+bool GameEngine::isTruncated() const
+{
+    return m_valueFunction && currentTrick().cards().isEmpty()
+        && tricksPlayed() - m_rootTricks >= m_playoutTricks;
+}
+
+int GameEngine::cardsPlayedCount() const
+{
+    return 4 * (m_tricks.size() - 1) + currentTrick().cards().size();
+}
+
+int GameEngine::remainingPoints(bool withBonus) const
+{
+    int points = 152 + 10 - m_scores[0].points - m_scores[1].points;
+    if (!withBonus)
+        return points;
+
+    // A run of four in every trick, the trump King and Queen together and any
+    // four of a kind that may still be played
+    SuitMasks open {{0, 0, 0, 0}};
+    for (const auto &p : m_players) {
+        for (const auto suit : Card::Suits)
+            open[Card::suitIndex(suit)] |= p->hand().suitMask(suit);
+    }
+    for (const auto &c : currentTrick().cards())
+        open[Card::suitIndex(c.suit())] |= 1 << Card::rankIndex(c.rank());
+    points += 50 * (9 - m_tricks.size());
+    const auto trumps = open[Card::suitIndex(m_trumpSuit)];
+    const uchar stuk = (1 << Card::rankIndex(Rank::King)) | (1 << Card::rankIndex(Rank::Queen));
+    if ((trumps & stuk) == stuk)
+        points += 20;
+    for (const auto rank : Card::Ranks) {
+        const uchar bit = 1 << Card::rankIndex(rank);
+        if (std::all_of(open.begin(), open.end(), [&](uchar mask) { return mask & bit; }))
+            points += rank == Rank::Jack ? 200 : 100;
+    }
+    return points;
+}
+
+// The cards the current player may still meet in a trick, per suit
+GameEngine::SuitMasks GameEngine::openCards() const
+{
+    SuitMasks open {{0, 0, 0, 0}};
+    for (uint p = 0; p < 4; ++p) {
+        if (p == currentPlayer())
+            continue;
+        for (const auto suit : Card::Suits)
+            open[Card::suitIndex(suit)] |= m_players[p]->hand().suitMask(suit);
+    }
+    for (const auto &c : currentTrick().cards())
+        open[Card::suitIndex(c.suit())] |= 1 << Card::rankIndex(c.rank());
+    return open;
 }
 
 bool GameEngine::isFinished() const
@@ -282,21 +597,22 @@ bool GameEngine::isFinished() const
     return m_tricks.size() == 8 && currentTrick().isComplete();
 }
 
-QVector<Card> GameEngine::minimumRank(const CardSet& hand, uint position) const
+template<TrumpRule Rule>
+bool GameEngine::minimumRank(const CardSet& hand, uint position, Card *minRank) const
 {
-    QVector<Card> minRank;
     // Allow all moves if the player is in first position or has too few cards
     if (position == 0 || hand.size() < 2)
-        return minRank;
+        return false;
 
     // Player must always follow suit if possible, otherwise the rules and
     // state of the game determine whether he must trump if possible
     const auto suitLed = currentTrick().suitLed();
     if (hand.containsSuit(suitLed)) {
         if (suitLed != m_trumpSuit) // Player can follow suit
-            minRank << Card(suitLed, Rank::Seven);
+            *minRank = Card(suitLed, Rank::Seven);
         else // Player must beat the highest trump played in this trick
-            minRank << currentTrick().winningCard();
+            *minRank = currentTrick().winningCard();
+        return true;
     } else {
         removeConstraint(currentPlayer(), suitLed);
         if (hand.containsSuit(m_trumpSuit)) {
@@ -304,36 +620,111 @@ QVector<Card> GameEngine::minimumRank(const CardSet& hand, uint position) const
             // trump, but is exempt from this under Amsterdam rules if his partner
             // is the current winner of the trick
             const auto winner = currentTrick().winner();
-            if (m_trumpRule != TrumpRule::Amsterdams || position - winner != 2) {
+            if (Rule != TrumpRule::Amsterdams || position - winner != 2) {
                 const auto &wCard = currentTrick().winningCard();
                 const auto rank = wCard.suit() == m_trumpSuit ? wCard.rank() : Rank::Seven;
-                minRank << Card(m_trumpSuit, rank);
+                *minRank = Card(m_trumpSuit, rank);
+                return true;
             }
         }
     }
-    return minRank;
+    return false;
 }
 
 void GameEngine::doMove(const Card move)
 {
+    Q_ASSERT(m_undoSize < UndoDepth);
+    auto &record = m_undoStack.records[m_undoSize++];
+    const auto &player = m_players.at(currentPlayer());
+    record.move = move;
+    record.player = m_currentPlayer;
+    record.handIndex = uchar(player->hand().indexOf(move));
+    record.hasSignal = false;
+    record.isMarch = m_isMarch;
+    record.scores = {{m_scores[0], m_scores[1]}};
+    for (uint p = 0; p < 4; ++p) {
+        const auto &constraints = m_playerConstraints[m_players[p]];
+        for (const auto suit : Card::Suits) {
+            const auto c = constraints.find(suit);
+            record.constraints[p][Card::suitIndex(suit)] = c == constraints.end() ? 0 : uchar(c->second);
+        }
+    }
+
     currentTrick().add(move);
-    m_players.at(currentPlayer())->removeCard(move);
+    player->removeCard(move);
     if (currentTrick().cards().size() > 2) {
         const auto signal = currentTrick().checkSignal();
         const auto suit = std::get<0>(signal);
-        if (signal != Trick::NullSignal && !m_playerSignals.value(currentPlayer()).contains(suit))
+        if (signal != Trick::NullSignal && !m_playerSignals.value(currentPlayer()).contains(suit)) {
             m_playerSignals[currentPlayer()].insert(suit, std::get<1>(signal));
+            record.hasSignal = true;
+            record.signalSuit = suit;
+        }
     }
     ++m_currentPlayer;
     if (currentTrick().isComplete())
         finishTrick();
 }
 
-// Score is kept in the first element of m_score for the first player's team
-// and the last element for the second player's team, in the order of m_players
+void GameEngine::undoMove()
+{
+    Q_ASSERT(canUndo());
+    const auto &record = m_undoStack.records[--m_undoSize];
+    // Drop the trick started after the move, unless it was the last one
+    if (currentTrick().cards().isEmpty())
+        m_tricks.removeLast();
+    currentTrick().removeLast();
+    m_currentPlayer = record.player;
+    m_players.at(currentPlayer())->insertCard(record.handIndex, record.move);
+    if (record.hasSignal)
+        m_playerSignals[currentPlayer()].remove(record.signalSuit);
+    m_isMarch = record.isMarch;
+    m_scores[0] = record.scores[0];
+    m_scores[1] = record.scores[1];
+    for (uint p = 0; p < 4; ++p) {
+        auto &constraints = m_playerConstraints[m_players[p]];
+        for (const auto suit : Card::Suits) {
+            const auto rank = record.constraints[p][Card::suitIndex(suit)];
+            if (rank == 0)
+                constraints.erase(suit);
+            else
+                constraints[suit] = Rank(rank);
+        }
+    }
+}
+
+bool GameEngine::canUndo() const
+{
+    return m_undoSize > 0;
+}
+
+/* Score is kept in the first element of m_score for the first player's team
+ * and the last element for the second player's team, in the order of
+ * m_players.
+ *
+ * A game cut short after a number of tricks is scored by the value function.
+ * A game cut short by early termination is scored as if the remaining card
+ * points were shared in proportion to the points won so far, without further
+ * bonuses. A failed contract gives the contractors nothing either way.
+ */
 qreal GameEngine::getResult(uint player) const
 {
-    return isFinished() ? m_scores[player % 2].sum() / 162.0 : -1;
+    if (isFinished())
+        return m_scores[player % 2].sum() / 162.0;
+    if (!isCutShort())
+        return -1;
+    if (!(m_earlyTermination && isDecided()))
+        return m_valueFunction->evaluate(*this)[player % 2];
+
+    const auto contractors = team(m_contractor);
+    const int contractorScore = m_scores[contractors].sum();
+    const int defenderScore = m_scores[1 - contractors].sum();
+    const int remaining = remainingPoints(false);
+    if (contractorScore <= defenderScore)
+        return player % 2 == contractors ? 0 : (contractorScore + defenderScore + remaining) / 162.0;
+    const qreal won = m_scores[0].points + m_scores[1].points;
+    const qreal share = won > 0 ? m_scores[player % 2].points / won : 0.5;
+    return (m_scores[player % 2].sum() + share * remaining) / 162.0;
 }
 
 inline RoundScore &GameEngine::teamScore(Position position)
@@ -385,6 +776,8 @@ void GameEngine::reset(Position firstPlayer, Position contractor, Card::Suit tru
     m_tricks = {{trumpSuit}};
     setDefaultConstraints();
     m_playerSignals.fill(SignalMap());
+    m_belief.reset();
+    m_undoSize = 0;
 }
 
 const QVector<Card> GameEngine::cardsPlayed() const
@@ -395,6 +788,77 @@ const QVector<Card> GameEngine::cardsPlayed() const
     return cards;
 }
 
+/* The signature of each suit is packed into two words: the first holds the
+ * rank masks of the four hands, those of the completed tricks and the (rank
+ * index + 1) of the card in each position of the current trick; the second
+ * holds the constraint and signal of each player in that suit.
+ */
+SuitPermutation GameEngine::canonicalPermutation() const
+{
+    using Signature = std::pair<quint64,quint64>;
+    std::array<Signature,4> signatures {};
+    for (int p = 0; p < 4; ++p) {
+        const auto &player = m_players[p];
+        const auto constraints = m_playerConstraints.value(player);
+        const auto signals = m_playerSignals.at(p);
+        for (const auto suit : Card::Suits) {
+            auto &signature = signatures[Card::suitIndex(suit)];
+            signature.first |= quint64(player->hand().suitMask(suit)) << (8 * p);
+            const auto c = constraints.find(suit);
+            if (c != constraints.end())
+                signature.second |= quint64(1 + rankOrder(suit == m_trumpSuit)[c->second]) << (4 * p);
+            signature.second |= quint64(signals.value(suit, Trick::Signal::None)) << (16 + 2 * p);
+        }
+    }
+    for (auto t = m_tricks.cbegin(), tEnd = m_tricks.cend() - 1; t < tEnd; ++t) {
+        for (const auto &c : t->cards())
+            signatures[Card::suitIndex(c.suit())].first |= quint64(1) << (32 + Card::rankIndex(c.rank()));
+    }
+    const auto &trick = currentTrick().cards();
+    for (int i = 0; i < trick.size(); ++i) {
+        const auto c = trick.at(i);
+        signatures[Card::suitIndex(c.suit())].first |= quint64(1 + Card::rankIndex(c.rank())) << (40 + 4 * i);
+    }
+    return SuitPermutation::fromSignatures(signatures, Card::suitIndex(m_trumpSuit));
+}
+
+std::unique_ptr<GameEngine> GameEngine::canonicalClone(SuitPermutation *permutation) const
+{
+    const auto canonical = canonicalPermutation();
+    auto clone = new GameEngine(*this);
+    clone->relabelSuits(canonical);
+    if (permutation)
+        *permutation = canonical;
+    return std::unique_ptr<GameEngine>(clone);
+}
+
+// Scores are invariant under relabelling, so they are kept as they are
+void GameEngine::relabelSuits(const SuitPermutation &permutation)
+{
+    for (const auto &player : m_players) {
+        player->setHand(permutation.map(player->hand()));
+        ConstraintSet relabelled;
+        for (const auto &c : m_playerConstraints.value(player))
+            relabelled[permutation.map(c.first)] = c.second;
+        m_playerConstraints[player] = relabelled;
+    }
+    for (auto &signals : m_playerSignals) {
+        SignalMap relabelled;
+        for (auto s = signals.cbegin(); s != signals.cend(); ++s)
+            relabelled.insert(permutation.map(s.key()), s.value());
+        signals = relabelled;
+    }
+    if (m_belief)
+        m_belief = std::make_shared<const Belief>(m_belief->relabelled(permutation));
+    m_trumpSuit = permutation.map(m_trumpSuit);
+    for (auto &trick : m_tricks) {
+        Trick relabelled(m_trumpSuit);
+        for (const auto &c : trick.cards())
+            relabelled.add(permutation.map(c));
+        trick = relabelled;
+    }
+}
+
 const QVector<RoundScore> GameEngine::scores() const
 {
     return m_scores;
@@ -415,6 +879,31 @@ Trick &GameEngine::currentTrick()
     return m_tricks.last();
 }
 
+Card::Suit GameEngine::trumpSuit() const
+{
+    return m_trumpSuit;
+}
+
+GameEngine::Position GameEngine::contractor() const
+{
+    return m_contractor;
+}
+
+const CardSet &GameEngine::hand(uint player) const
+{
+    return m_players.at(player)->hand();
+}
+
+int GameEngine::tricksPlayed() const
+{
+    return m_tricks.size() - (currentTrick().isComplete() ? 0 : 1);
+}
+
+bool GameEngine::isMarchPossible() const
+{
+    return m_isMarch;
+}
+
 const Trick &GameEngine::currentTrick() const
 {
     return m_tricks.last();
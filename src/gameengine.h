@@ -29,10 +29,16 @@
 #include <QtGlobal>
 #include <QVector>
 
+#include <array>
 #include <memory>
+#include <random>
+#include <vector>
 
 class BasePlayer;
+class Belief;
 class CardSet;
+class SuitPermutation;
+class ValueFunction;
 
 /**
  * Klaverjas game engine.
@@ -77,12 +83,90 @@ public:
     static std::unique_ptr<GameEngine> create(const PlayerList players, Position firstPlayer, Position contractor, TrumpRule trumpRule, Card::Suit trumpSuit);
     GameEngine() = delete;
 
+    /// An exact copy of this engine, holding copies of the players' hands
+    std::unique_ptr<GameEngine> clone() const;
     Ptr cloneAndRandomise(uint observer) const override;
+    /// Like cloneAndRandomise, but keeping the type of the engine
+    std::unique_ptr<GameEngine> determinisedClone(uint observer) const;
+    /// Determinise with the given generator, so that concurrent searches
+    /// need not share one
+    std::unique_ptr<GameEngine> determinisedClone(uint observer, std::mt19937 &random) const;
     uint currentPlayer() const override;
     std::vector<Card> validMoves() const override;
+    /// The valid moves as a mask of Card::id bits, in which validMoves are
+    /// generated
+    quint32 validMoveMask() const;
     void doMove(const Card move) override;
+    /**
+     * Take back the last move made on this engine.
+     *
+     * Hands, tricks, scores, constraints and signals are restored exactly, so
+     * a depth first search can run on a single engine. Moves made before the
+     * engine was copied or reset cannot be undone.
+     */
+    void undoMove();
+    /// Whether there is a move to undo
+    bool canUndo() const;
     qreal getResult(uint player) const override;
 
+    /**
+     * Whether two cards in the current player's hand are interchangeable.
+     *
+     * Equivalent cards lead to the same scores in every continuation of the
+     * game, so a search need only consider one of them. The relation depends
+     * on the cards that are still in play.
+     */
+    bool areEquivalent(Card a, Card b) const;
+    /// Group the given moves into classes of equivalent cards, see areEquivalent
+    std::vector<std::vector<Card>> equivalenceClasses(const std::vector<Card> &moves) const;
+    /**
+     * Have validMoves offer only the first move of each equivalence class.
+     *
+     * This narrows the search tree without changing its values. The setting
+     * is inherited by clones, so it is meant for the root of a search only;
+     * moves offered to people should not be merged.
+     */
+    void setMergeEquivalentMoves(bool merge);
+    /**
+     * End the game early once its outcome is decided, see isDecided.
+     *
+     * From then on, validMoves returns no moves and getResult returns the
+     * known result or an estimate, which cuts search playouts short. Like
+     * setMergeEquivalentMoves, this is inherited by clones; states up to the
+     * current one are never cut short.
+     */
+    void setEarlyTermination(bool enabled);
+    /**
+     * Whether the remaining cards cannot change whether the contract is made.
+     *
+     * This holds when the contractors cannot catch up with the defenders even
+     * if they win all remaining points, last trick and bonuses, or when they
+     * are certain to stay ahead and can no longer make a march.
+     */
+    bool isDecided() const;
+    /**
+     * Stop playouts after the given number of tricks and estimate their
+     * result with the value function instead.
+     *
+     * Like setEarlyTermination, this is inherited by clones and counts from
+     * the current state. A null function plays all tricks.
+     */
+    void setValueFunction(std::shared_ptr<const ValueFunction> function, int playoutTricks);
+    /**
+     * Prefer deals that fit what the players revealed when determinising.
+     *
+     * Each determinisation draws the given number of deals that satisfy the
+     * constraints and keeps one of them with a probability proportional to its
+     * dealWeight, which approaches sampling from the belief as the number
+     * grows. Like setValueFunction, this is inherited by clones; a new round
+     * starts without a belief, and a null belief or a single sample deals
+     * uniformly.
+     */
+    void setBelief(std::shared_ptr<const Belief> belief, int samples);
+    /// The likelihood of the hands of the players other than the observer
+    /// under the belief and the signals given so far, 1 without a belief;
+    /// may underflow to 0, unlike the logarithm that determinisation uses
+    qreal dealWeight(uint observer) const;
     /// Whether the game is finished, i.e. all 32 cards have been played
     bool isFinished() const;
     /// Start a game with the same rules and players, but a new trump bid.
@@ -91,9 +175,55 @@ public:
     const QVector<Card> cardsPlayed() const;
     const QVector<RoundScore> scores() const;
     const Trick &currentTrick() const;
+    Card::Suit trumpSuit() const;
+    Position contractor() const;
+    const CardSet &hand(uint player) const;
+    /// The number of completed tricks
+    int tricksPlayed() const;
+    /// Whether the contractors have won all tricks so far
+    bool isMarchPossible() const;
+
+    /**
+     * Copy this engine with its suits relabelled to canonical form.
+     *
+     * The suits are ordered by the hands, the cards played so far and the
+     * players' constraints and signals, so two states that only differ by a
+     * relabelling of the non-trump suits give equal copies.
+     *
+     * @param permutation If given, receives the permutation that was applied.
+     *      Moves in the copy map back to this engine through its inverse.
+     */
+    std::unique_ptr<GameEngine> canonicalClone(SuitPermutation *permutation = nullptr) const;
+    /// The permutation that brings this engine's state into canonical form
+    SuitPermutation canonicalPermutation() const;
 
 private:
     using SignalMap = QMap<Card::Suit,Trick::Signal>;
+    using SuitMasks = std::array<uchar,4>;
+    // What doMove changes besides the trick and the hand, with ranks of 0 for
+    // suits removed from a player's constraints
+    struct UndoRecord
+    {
+        Card move;
+        Position player;
+        uchar handIndex;
+        Card::Suit signalSuit;
+        bool hasSignal;
+        bool isMarch;
+        std::array<RoundScore,2> scores;
+        std::array<std::array<uchar,4>,4> constraints;
+    };
+    static const int UndoDepth = 32;
+    // Copies of an engine start without moves to undo, so the records are
+    // left out of copies altogether
+    struct UndoStack
+    {
+        UndoStack() = default;
+        UndoStack(const UndoStack &) {}
+        UndoStack &operator=(const UndoStack &) { return *this; }
+
+        std::array<UndoRecord,UndoDepth> records;
+    };
     PlayerList m_players;
     QVector<Trick> m_tricks;
     /* For now, the constraints work as follows: if it's unknown to other
@@ -110,6 +240,18 @@ private:
     Position m_currentPlayer;
     Position m_contractor;
     bool m_isMarch;
+    bool m_mergeEquivalentMoves;
+    bool m_earlyTermination;
+    int m_terminationFloor;
+    std::shared_ptr<const ValueFunction> m_valueFunction;
+    int m_playoutTricks;
+    int m_rootTricks;
+    std::shared_ptr<const Belief> m_belief;
+    int m_beliefSamples;
+    UndoStack m_undoStack;
+    int m_undoSize;
+    // The instance of legalMoves for m_trumpRule
+    quint32 (GameEngine::*m_legalMoves)() const;
 
     // Only BaseGame may construct itself
     GameEngine(const PlayerList players, Position firstPlayer, Position contractor, TrumpRule trumpRule, Card::Suit trumpSuit);
@@ -118,6 +260,19 @@ private:
     RoundScore &teamScore(Position position);
     void finishTrick();
     void finishGame();
+    void relabelSuits(const SuitPermutation &permutation);
+    /// All legal moves of the current player as a mask of Card::id bits,
+    /// compiled for each trump rule
+    template<TrumpRule Rule> quint32 legalMoves() const;
+    SuitMasks openCards() const;
+    int cardsPlayedCount() const;
+    bool isCutShort() const;
+    bool isTruncated() const;
+    /// Points still to be won: card values, the last trick bonus and an upper
+    /// bound on the bonuses
+    int remainingPoints(bool withBonus) const;
+    bool areEquivalent(Card a, Card b, const SuitMasks &open) const;
+    qreal dealLogWeight(uint observer) const;
 
     /**
     * Collect the cards held by each player other than the observer and give
@@ -125,8 +280,8 @@ private:
     *
     * @param observer The player observing this game.
     */
-    void determiniseCards(uint observer) const;
-    void constrainedDeal(const PlayerList players, const QVector<Card> cards) const;
+    void determiniseCards(uint observer, std::mt19937 &random) const;
+    void constrainedDeal(const PlayerList players, const QVector<Card> cards, std::mt19937 &random) const;
 
     QVector<Card> signalCards (QVector<Card> &unknowns, uint player) const;
 
@@ -138,10 +293,12 @@ private:
     *
     * @param hand The player's cards.
     * @param position The position (0, 1, 2 or 3) the player is moving from.
-    * @return A vector that contains a single card if the player should beat a
-    *       given rank and suit, or an empty vector if any move is valid.
+    * @param minRank Receives the card to beat, if any.
+    * @return True if the player should beat the given rank and suit, false if
+    *       any move is valid.
     */
-    QVector<Card> minimumRank(const CardSet& hand, uint position) const;
+    template<TrumpRule Rule>
+    bool minimumRank(const CardSet& hand, uint position, Card *minRank) const;
 
     void setDefaultConstraints() const;
     void setConstraint(uint player, Card::Suit suit, Card::Rank rank) const;
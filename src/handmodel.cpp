@@ -0,0 +1,97 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "handmodel.h"
+
+HandModel::HandModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int HandModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_cards.size();
+}
+
+QVariant HandModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_cards.size() || role != CardRole)
+        return QVariant();
+    return QVariant::fromValue(m_cards.at(index.row()));
+}
+
+QHash<int,QByteArray> HandModel::roleNames() const
+{
+    return {{CardRole, "card"}};
+}
+
+void HandModel::setCards(const QVector<Card> &cards)
+{
+    if (m_cards.isEmpty() && !cards.isEmpty()) {
+        beginInsertRows(QModelIndex(), 0, cards.size() - 1);
+        m_cards = cards;
+        endInsertRows();
+    } else if (!m_cards.isEmpty() && cards.isEmpty()) {
+        beginRemoveRows(QModelIndex(), 0, m_cards.size() - 1);
+        m_cards.clear();
+        endRemoveRows();
+    } else if (m_cards != cards) {
+        beginResetModel();
+        m_cards = cards;
+        endResetModel();
+    }
+}
+
+void HandModel::removeCard(Card card)
+{
+    const int row = m_cards.indexOf(card);
+    if (row < 0)
+        return;
+    beginRemoveRows(QModelIndex(), row, row);
+    m_cards.remove(row);
+    endRemoveRows();
+}
+
+void HandModel::insertCard(int row, Card card)
+{
+    if (row < 0 || row > m_cards.size() || m_cards.contains(card))
+        return;
+    beginInsertRows(QModelIndex(), row, row);
+    m_cards.insert(row, card);
+    endInsertRows();
+}
+
+void HandModel::reorder(const QVector<Card> &cards)
+{
+    if (cards == m_cards)
+        return;
+    if (cards.size() != m_cards.size())
+        return setCards(cards);
+
+    emit layoutAboutToBeChanged();
+    const auto oldCards = m_cards;
+    m_cards = cards;
+    const auto persistent = persistentIndexList();
+    QModelIndexList moved;
+    moved.reserve(persistent.size());
+    for (const auto &index : persistent)
+        moved << this->index(m_cards.indexOf(oldCards.at(index.row())));
+    changePersistentIndexList(persistent, moved);
+    emit layoutChanged();
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef HANDMODEL_H
+#define HANDMODEL_H
+
+#include "card.h"
+
+#include <QAbstractListModel>
+#include <QVector>
+
+/**
+ * List model of the cards in a player's hand.
+ *
+ * Unlike the list returned by CardSet::cards, the model reports changes as
+ * they happen: a deal inserts rows, playing a card removes its row, taking it
+ * back inserts it again and sorting changes the layout. Views can therefore
+ * keep the delegates of the cards that remain. The card of each row is
+ * available as the "card" role.
+ */
+class HandModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        CardRole = Qt::UserRole + 1
+    };
+
+    explicit HandModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = CardRole) const override;
+    QHash<int,QByteArray> roleNames() const override;
+
+    /// Replace the hand, inserting rows if it was empty
+    void setCards(const QVector<Card> &cards);
+    void removeCard(Card card);
+    /// Insert a card at the given row, e.g. when a move is taken back
+    void insertCard(int row, Card card);
+    /// Rearrange the hand into the given order of the same cards
+    void reorder(const QVector<Card> &cards);
+
+private:
+    QVector<Card> m_cards;
+};
+
+#endif // HANDMODEL_H
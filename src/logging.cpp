@@ -0,0 +1,31 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Logging categories shared by the game, the server and the engine protocol
+
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(klaverjas, "klaverjas")
+Q_LOGGING_CATEGORY(klaverjasGame, "klaverjas.game")
+Q_LOGGING_CATEGORY(klaverjasPlayer, "klaverjas.player")
+Q_LOGGING_CATEGORY(klaverjasAi, "klaverjas.ai")
+Q_LOGGING_CATEGORY(klaverjasTrick, "klaverjas.trick")
+Q_LOGGING_CATEGORY(klaverjasTable, "klaverjas.table")
+Q_LOGGING_CATEGORY(klaverjasTest, "klaverjas.aitest")
+Q_LOGGING_CATEGORY(klaverjasProtocol, "klaverjas.protocol")
@@ -26,9 +26,17 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "team.h"
 #include "players/player.h"
 #include "players/humanplayer.h"
+#include "players/aiplayer.h"
 #include "cardimageprovider.h"
+#include "carditem.h"
+#include "handmodel.h"
+#include "scoremodel.h"
+#include "valuefunction.h"
+#include "search/searchtree.h"
+#include "tables/tableserver.h"
 
 // Qt headers
+#include <QCoreApplication>
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
@@ -38,15 +46,71 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QTime>
 
 Q_DECLARE_LOGGING_CATEGORY(klaverjas)
-Q_LOGGING_CATEGORY(klaverjas, "klaverjas")
-Q_LOGGING_CATEGORY(klaverjasGame, "klaverjas.game")
-Q_LOGGING_CATEGORY(klaverjasPlayer, "klaverjas.player")
-Q_LOGGING_CATEGORY(klaverjasAi, "klaverjas.ai")
-Q_LOGGING_CATEGORY(klaverjasTrick, "klaverjas.trick")
-Q_LOGGING_CATEGORY(klaverjasTest, "klaverjas.aitest")
+
+namespace {
+
+const QCommandLineOption ServerOption("server", "Serve tables without interface on the local socket <name>.", "name");
+const QCommandLineOption ValueFunctionOption("value-function", "Shorten AI search playouts with the value function in <file>.", "file");
+const QCommandLineOption PonderLoadOption("ponder-load", "Share of the processor in percent the AI may use while you are thinking, 0 to disable.", "percent", "50");
+const QCommandLineOption AiThreadsOption("ai-threads", "Number of threads the AI searches each move with.", "count", "1");
+const QCommandLineOption AiProducersOption("ai-producers", "Number of extra threads that prepare random deals for the AI search, 0 to let the search threads do it.", "count", "0");
+const QCommandLineOption AiSearchOption("ai-search", "The AI search: tree, the default, or library.", "search", "tree");
+const QCommandLineOption AiTimeOption("ai-time", "Let the AI search each move for <ms> milliseconds instead of a fixed number of iterations.", "ms", "0");
+const QCommandLineOption AiMemoryOption("ai-memory", "Limit the search tree of each AI player to <MiB> mebibytes, 0 for no limit.", "MiB", "0");
+const QCommandLineOption SearchThreadsOption("search-threads", "Maximum number of concurrent AI searches in server mode.", "count", "0");
+
+// Returns false if a value function was given but could not be loaded
+bool loadValueFunction(const QCommandLineParser &parser)
+{
+    if (!parser.isSet(ValueFunctionOption))
+        return true;
+    const auto function = ValueFunction::load(parser.value(ValueFunctionOption));
+    if (!function) {
+        qCCritical(klaverjas) << "Cannot load value function" << parser.value(ValueFunctionOption);
+        return false;
+    }
+    ValueFunction::setShared(function);
+    return true;
+}
+
+// Run the headless table server, see TableServer for the protocol
+int runServer(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName(QStringLiteral("klaverjas"));
+    app.setApplicationVersion(QStringLiteral("%{VERSION}"));
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOption(ServerOption);
+    parser.addOption(SearchThreadsOption);
+    parser.addOption(ValueFunctionOption);
+    parser.process(app);
+    if (!loadValueFunction(parser))
+        return 1;
+
+    QLoggingCategory::setFilterRules("klaverjas.*.debug=false\n"
+        "klaverjas.table.debug=true"
+    );
+    std::srand(QTime::currentTime().msec());
+
+    TableServer server(parser.value(SearchThreadsOption).toInt());
+    if (!server.listen(parser.value(ServerOption))) {
+        qCCritical(klaverjas) << "Cannot listen on" << parser.value(ServerOption) << server.errorString();
+        return 1;
+    }
+    return app.exec();
+}
+
+} // namespace
 
 int main(int argc, char **argv)
 {
+    for (int i = 1; i < argc; ++i) {
+        if (QByteArray(argv[i]).startsWith("--server"))
+            return runServer(argc, argv);
+    }
+
     QGuiApplication app(argc, argv);
     app.setApplicationName(QStringLiteral("klaverjas"));
     app.setApplicationDisplayName("Klaverjas");
@@ -56,7 +120,24 @@ int main(int argc, char **argv)
     QCommandLineParser parser;
     parser.addHelpOption();
     parser.addVersionOption();
+    parser.addOption(ServerOption);
+    parser.addOption(ValueFunctionOption);
+    parser.addOption(PonderLoadOption);
+    parser.addOption(AiThreadsOption);
+    parser.addOption(AiProducersOption);
+    parser.addOption(AiSearchOption);
+    parser.addOption(AiTimeOption);
+    parser.addOption(AiMemoryOption);
     parser.process(app);
+    if (!loadValueFunction(parser))
+        return 1;
+    SearchTree::setPonderLoad(parser.value(PonderLoadOption).toInt());
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, []{ SearchTree::setPonderLoad(0); });
+    AiPlayer::setSearchThreads(parser.value(AiThreadsOption).toInt());
+    AiPlayer::setProducers(parser.value(AiProducersOption).toInt());
+    AiPlayer::setMoveTime(parser.value(AiTimeOption).toInt());
+    AiPlayer::setMemoryLimit(parser.value(AiMemoryOption).toLongLong() * 1024 * 1024);
+    AiPlayer::setSearch(parser.value(AiSearchOption) == "library" ? AiPlayer::Search::Library : AiPlayer::Search::Tree);
 
     qmlRegisterUncreatableType<Game>("org.kde.klaverjas", 1, 0, "Game", "Only available as context object \"game\".");
     qmlRegisterUncreatableType<Card>("org.kde.klaverjas", 1, 0, "Card", "Enum/property access only.");
@@ -64,6 +145,9 @@ int main(int argc, char **argv)
     qmlRegisterUncreatableType<Player>("org.kde.klaverjas", 1, 0, "Player", "Abstract class.");
     qmlRegisterType<HumanPlayer>("org.kde.klaverjas", 1, 0, "HumanPlayer");
     qmlRegisterType<Team>("org.kde.klaverjas", 1, 0, "Team");
+    qmlRegisterUncreatableType<ScoreModel>("org.kde.klaverjas", 1, 0, "ScoreModel", "Property access only.");
+    qmlRegisterUncreatableType<HandModel>("org.kde.klaverjas", 1, 0, "HandModel", "Property access only.");
+    qmlRegisterType<CardItem>("org.kde.klaverjas", 1, 0, "CardItem");
     qRegisterMetaType<CardSet>("CardSet");
     qRegisterMetaType<Card::Suit>("Suit");
     qRegisterMetaType<Card::Rank>("Rank");
@@ -0,0 +1,78 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "notation.h"
+
+#include <QStringList>
+
+namespace {
+
+const QString SuitLetters = QStringLiteral("CDHS");
+const QString RankLetters = QStringLiteral("789TKQJA");
+
+} // namespace
+
+namespace Notation
+{
+
+QString suit(Card::Suit suit)
+{
+    return SuitLetters.at(Card::suitIndex(suit));
+}
+
+bool parseSuit(const QString &text, Card::Suit *suit)
+{
+    const int index = text.size() == 1 ? SuitLetters.indexOf(text.at(0).toUpper()) : -1;
+    if (index < 0)
+        return false;
+    *suit = Card::Suit(index << 4);
+    return true;
+}
+
+QString card(Card card)
+{
+    return RankLetters.at(Card::rankIndex(card.rank())) + suit(card.suit());
+}
+
+bool parseCard(const QString &text, Card *card)
+{
+    Card::Suit s;
+    if (text.size() != 2 || !parseSuit(text.right(1), &s))
+        return false;
+    const int rank = RankLetters.indexOf(text.at(0).toUpper());
+    if (rank < 0)
+        return false;
+    *card = Card(s, Card::Rank(rank + int(Card::Rank::Seven)));
+    return true;
+}
+
+QString cards(const QVector<Card> &cards)
+{
+    QStringList names;
+    for (const auto &c : cards)
+        names << card(c);
+    return names.join(' ');
+}
+
+QString cards(const std::vector<Card> &cards)
+{
+    return Notation::cards(QVector<Card>::fromStdVector(cards));
+}
+
+} // namespace Notation
@@ -0,0 +1,49 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef NOTATION_H
+#define NOTATION_H
+
+#include "card.h"
+
+#include <QString>
+#include <QVector>
+
+#include <vector>
+
+/**
+ * Plain text notation for the command line protocols.
+ *
+ * Suits are written as C, D, H or S and ranks as 7, 8, 9, T, J, Q, K or A,
+ * so that a card such as the ten of hearts reads "TH". Lists are separated by
+ * single spaces.
+ */
+namespace Notation
+{
+
+QString suit(Card::Suit suit);
+bool parseSuit(const QString &text, Card::Suit *suit);
+QString card(Card card);
+bool parseCard(const QString &text, Card *card);
+QString cards(const QVector<Card> &cards);
+QString cards(const std::vector<Card> &cards);
+
+} // namespace Notation
+
+#endif // NOTATION_H
@@ -0,0 +1,222 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Count the legal play sequences from fixed deals, in the manner of perft in
+ * chess engines. The counts check the move generation of GameEngine against
+ * known values and the time taken serves as a throughput benchmark.
+ */
+
+#include "gameengine.h"
+#include "notation.h"
+#include "players/baseplayer.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QLoggingCategory>
+#include <QStringList>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+struct Reference
+{
+    const char *deal;
+    char trump;
+    TrumpRule rule;
+    /// Known counts at depths 4, 8, 12 and 16
+    quint64 nodes[4];
+};
+
+// Deals list the hands of North, East, South and West; North leads and bids
+const Reference References[] = {
+    {"9S 8H TD 9D KS 8C QC KC AC 7H 8D TH JS QD JH 7C QH QS JC KD KH AH JD AD TC AS 9C 7S 8S TS 9H 7D",
+        'H', TrumpRule::Amsterdams, {36, 1710, 85522, 3414776}},
+    {"7H 8S 9H AS QS KH 7C KC 9D AC JD 8H JH KS AD KD QD TS 8C 7S JC TH 7D 8D QH AH QC 9S TD JS 9C TC",
+        'S', TrumpRule::Rotterdams, {32, 1888, 63024, 1923936}},
+    {"8D 7S JD 9D KS 8C QC TC JH QH QD KD AH 7H TS JC AC QS 7D 8S 7C 9S 9C JS KH AS TH TD KC 8H 9H AD",
+        'C', TrumpRule::Amsterdams, {29, 9240, 425872, 28919424}},
+    {"7D QC TH KH 9S QD JC 9D JH QS JD 9H KS QH 8S TD 7H AC 8C JS 8H TS 7C 7S 9C KC AS KD AH TC 8D AD",
+        'D', TrumpRule::Rotterdams, {145, 6768, 313866, 15772548}}
+};
+
+const char *const RuleNames[] = {"amsterdams", "rotterdams"};
+
+std::unique_ptr<GameEngine> setUp(const QString &deal, Card::Suit trump, TrumpRule rule)
+{
+    const auto names = deal.split(' ', QString::SkipEmptyParts);
+    if (names.size() != 32)
+        return nullptr;
+    GameEngine::PlayerList players;
+    for (int p = 0; p < 4; ++p) {
+        CardSet hand;
+        for (int i = 0; i < 8; ++i) {
+            Card card;
+            if (!Notation::parseCard(names.at(p * 8 + i), &card))
+                return nullptr;
+            hand << card;
+        }
+        players << std::make_shared<BasePlayer>();
+        players.last()->setHand(hand);
+    }
+    return GameEngine::create(players, GameEngine::Position::North, GameEngine::Position::North, rule, trump);
+}
+
+// Runs in place, undoing each move after counting its subtree
+quint64 perft(GameEngine &engine, int depth)
+{
+    if (depth == 0 || engine.isFinished())
+        return 1;
+    const auto moves = engine.validMoves();
+    if (depth == 1)
+        return moves.size();
+    quint64 nodes = 0;
+    for (const auto &move : moves) {
+        engine.doMove(move);
+        nodes += perft(engine, depth - 1);
+        engine.undoMove();
+    }
+    return nodes;
+}
+
+// Split the tree a few plies down and count copies of the subtrees on the pool
+quint64 parallelPerft(const GameEngine &engine, int depth, QThreadPool *pool)
+{
+    std::vector<std::shared_ptr<GameEngine>> frontier {engine.clone()};
+    int splitDepth = 0;
+    while (splitDepth < depth - 1 && int(frontier.size()) < 4 * pool->maxThreadCount()) {
+        std::vector<std::shared_ptr<GameEngine>> next;
+        for (const auto &state : frontier) {
+            if (state->isFinished()) {
+                next.push_back(state);
+                continue;
+            }
+            for (const auto &move : state->validMoves()) {
+                next.push_back(state->clone());
+                next.back()->doMove(move);
+            }
+        }
+        frontier.swap(next);
+        ++splitDepth;
+    }
+
+    QVector<QFuture<quint64>> jobs;
+    for (const auto &state : frontier) {
+        const int remaining = state->isFinished() ? 0 : depth - splitDepth;
+        jobs << QtConcurrent::run(pool, [state, remaining]{ return perft(*state, remaining); });
+    }
+    quint64 nodes = 0;
+    for (auto &job : jobs)
+        nodes += job.result();
+    return nodes;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName(QStringLiteral("klaverjas-perft"));
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Count the legal play sequences from a deal. Without --deal, "
+        "the reference deals are counted and checked against their known counts.");
+    parser.addHelpOption();
+    const QCommandLineOption depthOption("depth", "Number of cards to play, at most 32.", "n", "12");
+    const QCommandLineOption threadsOption("threads", "Number of threads, 0 for one per core.", "n", "1");
+    const QCommandLineOption dealOption("deal", "The 32 cards of North, East, South and West, e.g. \"JC 9C ...\".", "cards");
+    const QCommandLineOption trumpOption("trump", "Trump suit of the deal: C, D, H or S.", "suit", "C");
+    const QCommandLineOption rotterdamsOption("rotterdams", "Play the deal by the Rotterdam trump rule.");
+    parser.addOptions({depthOption, threadsOption, dealOption, trumpOption, rotterdamsOption});
+    parser.process(app);
+    QLoggingCategory::setFilterRules("klaverjas.*.debug=false");
+
+    const int depth = parser.value(depthOption).toInt();
+    const int threads = parser.value(threadsOption).toInt();
+    if (depth < 1 || depth > 32 || threads < 0) {
+        std::fprintf(stderr, "Invalid depth or number of threads\n");
+        return 2;
+    }
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads > 0 ? threads : QThread::idealThreadCount());
+
+    struct Job
+    {
+        std::unique_ptr<GameEngine> engine;
+        TrumpRule rule;
+        qint64 expected;
+    };
+    std::vector<Job> jobs;
+    if (parser.isSet(dealOption)) {
+        Card::Suit trump;
+        if (!Notation::parseSuit(parser.value(trumpOption), &trump)) {
+            std::fprintf(stderr, "Invalid trump suit\n");
+            return 2;
+        }
+        const auto rule = parser.isSet(rotterdamsOption) ? TrumpRule::Rotterdams : TrumpRule::Amsterdams;
+        jobs.push_back({setUp(parser.value(dealOption), trump, rule), rule, -1});
+    } else {
+        for (const auto &reference : References) {
+            Card::Suit trump;
+            Notation::parseSuit(QString(QChar(reference.trump)), &trump);
+            const qint64 expected = depth % 4 == 0 && depth <= 16 ? qint64(reference.nodes[depth / 4 - 1]) : -1;
+            jobs.push_back({setUp(reference.deal, trump, reference.rule), reference.rule, expected});
+        }
+    }
+
+    QTextStream out(stdout);
+    bool passed = true;
+    // Totals per trump rule, to compare the rules' move generation
+    quint64 totalNodes[2] = {0, 0};
+    qint64 totalTime[2] = {0, 0};
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        if (!jobs[i].engine) {
+            std::fprintf(stderr, "Invalid deal\n");
+            return 2;
+        }
+        QElapsedTimer timer;
+        timer.start();
+        const quint64 nodes = pool.maxThreadCount() > 1
+            ? parallelPerft(*jobs[i].engine, depth, &pool) : perft(*jobs[i].engine, depth);
+        const qint64 elapsed = qMax<qint64>(timer.elapsed(), 1);
+        const int rule = jobs[i].rule == TrumpRule::Amsterdams ? 0 : 1;
+        totalNodes[rule] += nodes;
+        totalTime[rule] += elapsed;
+        out << "deal " << i + 1 << ' ' << RuleNames[rule] << " depth " << depth << " nodes " << nodes << " time " << elapsed
+            << " ms nps " << nodes * 1000 / elapsed;
+        if (jobs[i].expected >= 0) {
+            const bool ok = nodes == quint64(jobs[i].expected);
+            passed = passed && ok;
+            out << (ok ? " ok" : QString(" FAILED, expected %1").arg(jobs[i].expected));
+        }
+        out << '\n';
+    }
+    for (int rule = 0; rule < 2 && jobs.size() > 1; ++rule) {
+        out << "total " << RuleNames[rule] << " nodes " << totalNodes[rule] << " time " << totalTime[rule]
+            << " ms nps " << totalNodes[rule] * 1000 / qMax<qint64>(totalTime[rule], 1) << '\n';
+    }
+    return passed ? 0 : 1;
+}
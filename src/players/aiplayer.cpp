@@ -20,25 +20,133 @@
 #include "aiplayer.h"
 #include "card.h"
 #include "game.h"
+#include "trace.h"
+#include "valuefunction.h"
 
 #include <QString>
 #include <QVector>
 #include <QLoggingCategory>
 
+#include <algorithm>
+#include <atomic>
+
 Q_DECLARE_LOGGING_CATEGORY(klaverjasAi);
 
+namespace {
+
+std::atomic<int> searchThreads(1);
+std::atomic<int> producers(0);
+std::atomic<int> moveTime(0);
+std::atomic<qint64> memoryLimit(0);
+std::atomic<bool> useLibrary(false);
+
+std::unique_ptr<GameEngine> searchRoot(const GameEngine &engine)
+{
+    auto root = engine.clone();
+    root->setMergeEquivalentMoves(true);
+    root->setEarlyTermination(true);
+    root->setValueFunction(ValueFunction::shared(), ValueFunction::PlayoutTricks);
+    return root;
+}
+
+} // namespace
+
 AiPlayer::AiPlayer(QString name, Game *parent)
     : RandomPlayer(name, parent)
     , m_game(parent)
+    , m_search(2500)
     , m_solver(2500)
 {
+    if (!parent)
+        return;
+    connect(parent, &Game::newRound, this, [this]{ newRound(); });
+    connect(parent, &Game::moveRequested, this, [this]{ ponder(); });
+    connect(parent, &Game::cardPlayed, this, [this]{ m_search.stopPondering(); });
 }
 
 void AiPlayer::selectMove(const std::vector<Card> &legalMoves) const
 {
-    Q_UNUSED(legalMoves)
-    if (m_game->engine()) {
-        Card move = m_solver(*m_game->engine());
-        emit moveSelected(move);
+    const auto engine = m_game->engine();
+    if (!engine || legalMoves.empty())
+        return;
+
+    const auto first = legalMoves.front();
+    const bool isForced = std::all_of(legalMoves.begin() + 1, legalMoves.end(), [&](const Card &move) {
+        return engine->areEquivalent(first, move);
+    });
+    if (isForced) {
+        qCDebug(klaverjasAi) << m_name << "has no choice but" << first;
+        emit moveSelected(first);
+        return;
+    }
+
+    const auto key = informationSetKey();
+    auto cached = m_decisions.constFind(key);
+    if (cached == m_decisions.cend()) {
+        KLAVERJAS_TRACE("ai", "AiPlayer::search");
+        const auto root = searchRoot(*engine);
+        m_search.setThreads(searchThreads);
+        m_search.setProducers(producers);
+        m_search.setMoveTime(moveTime);
+        m_search.setMemoryLimit(memoryLimit);
+        cached = m_decisions.insert(key, useLibrary ? m_solver(*root) : m_search(*root));
     }
+    emit moveSelected(*cached);
+}
+
+void AiPlayer::setSearch(Search search)
+{
+    useLibrary = search == Search::Library;
+}
+
+void AiPlayer::setSearchThreads(int threads)
+{
+    searchThreads = threads;
+}
+
+void AiPlayer::setProducers(int count)
+{
+    producers = count;
+}
+
+void AiPlayer::setMoveTime(int milliseconds)
+{
+    moveTime = milliseconds;
+}
+
+void AiPlayer::setMemoryLimit(qint64 bytes)
+{
+    memoryLimit = bytes;
+}
+
+// Use the time a person takes to move to grow the tree for the moves after
+// theirs
+void AiPlayer::ponder()
+{
+    const auto engine = m_game->engine();
+    const auto human = m_game->humanPlayer();
+    if (engine && human && m_game->currentPlayerPtr() == human && !useLibrary) {
+        m_search.setMemoryLimit(memoryLimit);
+        m_search.ponder(searchRoot(*engine), uint(m_game->playerIndex(this)));
+    }
+}
+
+// The cache and the search tree only apply to a single round
+void AiPlayer::newRound()
+{
+    m_decisions.clear();
+    m_search.reset();
+}
+
+// The player's own cards and all cards played so far, in order
+QByteArray AiPlayer::informationSetKey() const
+{
+    quint32 hand = 0;
+    for (const auto &card : m_hand)
+        hand |= 1u << card.id();
+    QByteArray key(reinterpret_cast<const char *>(&hand), sizeof(hand));
+    key.append(char(m_game->trumpSuit()));
+    for (const auto &card : m_game->engine()->cardsPlayed())
+        key.append(char(card.id()));
+    return key;
 }
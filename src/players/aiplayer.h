@@ -21,21 +21,57 @@
 #define AIPLAYER_H
 
 #include "randomplayer.h"
+#include "search/searchtree.h"
 #include <ismcts/sosolver.h>
 
+#include <QByteArray>
+#include <QHash>
+
 class Game;
 
+/**
+ * Player that searches its moves with information set MCTS.
+ *
+ * The search is skipped when the legal moves are all equivalent, and moves
+ * are cached for the rest of the round by the information available to the
+ * player, so a repeated request is answered without searching again. The
+ * search tree is kept between moves and only discarded when the game starts
+ * a new round, see SearchTree. While the human player is to move, the tree
+ * is grown in the background. The generic solver of the ismcsolver library
+ * can be used instead, without these features.
+ */
 class AiPlayer : public RandomPlayer
 {
 public:
+    enum class Search { Tree, Library };
+
     explicit AiPlayer(QString name = "", Game *parent = nullptr);
 
+    /// Search with SearchTree or ISMCTS::SOSolver, the former by default
+    static void setSearch(Search search);
+    /// Search each move on this many threads sharing one tree, 1 by default
+    static void setSearchThreads(int threads);
+    /// Determinise states for the tree search on this many extra threads,
+    /// 0 by default, see SearchTree::setProducers
+    static void setProducers(int producers);
+    /// Search each move for this long instead of 2500 iterations, if positive;
+    /// the library solver always runs 2500 iterations
+    static void setMoveTime(int milliseconds);
+    /// Limit the memory of each player's search tree, see SearchTree
+    static void setMemoryLimit(qint64 bytes);
+
 public slots:
     void selectMove(const std::vector<Card> &legalMoves) const override;
 
 private:
+    QByteArray informationSetKey() const;
+    void ponder();
+    void newRound();
+
     const Game *m_game;
+    mutable SearchTree m_search;
     ISMCTS::SOSolver<Card> m_solver;
+    mutable QHash<QByteArray,Card> m_decisions;
 };
 
 #endif // AIPLAYER_H
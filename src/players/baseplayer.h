@@ -34,6 +34,8 @@ public:
     const CardSet &hand() const { return m_hand; }
     virtual void setHand(const CardSet &cards) { m_hand = cards; }
     virtual void removeCard(Card card) { m_hand.remove(card); }
+    /// Put a removed card back at its former position
+    virtual void insertCard(int index, Card card) { m_hand.insert(index, card); }
 
 protected:
     CardSet m_hand;
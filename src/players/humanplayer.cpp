@@ -32,11 +32,13 @@ void HumanPlayer::selectMove(const std::vector<Card> &legalMoves) const
 void HumanPlayer::bidSort()
 {
     m_hand.sortAll();
+    m_handModel->reorder(m_hand);
     emit handChanged();
 }
 
 void HumanPlayer::playSort(Card::Suit trumpSuit)
 {
     m_hand.sortAll(m_suitOrder, trumpSuit);
+    m_handModel->reorder(m_hand);
     emit handChanged();
 }
@@ -31,6 +31,7 @@ Player::Player(QString name, Game *parent)
     , m_name(name)
     , m_team(nullptr)
     , m_suitOrder(CardSet::SuitOrder::TrumpFirst)
+    , m_handModel(new HandModel(this))
 {
     m_hand.reserve(8);
 }
@@ -48,9 +49,15 @@ void Player::setName(const QString &name)
 void Player::setHand(const CardSet &cards)
 {
     BasePlayer::setHand(cards);
+    m_handModel->setCards(m_hand);
     emit handChanged();
 }
 
+HandModel *Player::handModel() const
+{
+    return m_handModel;
+}
+
 Team *Player::team() const
 {
     return m_team;
@@ -69,6 +76,14 @@ void Player::setSuitOrder(CardSet::SuitOrder order)
 void Player::removeCard(Card card)
 {
     BasePlayer::removeCard(card);
+    m_handModel->removeCard(card);
+    emit handChanged();
+}
+
+void Player::insertCard(int index, Card card)
+{
+    BasePlayer::insertCard(index, card);
+    m_handModel->insertCard(m_hand.indexOf(card), card);
     emit handChanged();
 }
 
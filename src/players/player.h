@@ -23,6 +23,7 @@
 #include "baseplayer.h"
 #include "card.h"
 #include "cardset.h"
+#include "handmodel.h"
 
 #include <QObject>
 #include <QString>
@@ -42,6 +43,7 @@ class Player : public QObject, public BasePlayer
     Q_OBJECT
     Q_PROPERTY(QString name READ name CONSTANT)
     Q_PROPERTY(CardSet hand READ hand NOTIFY handChanged)
+    Q_PROPERTY(HandModel *handModel READ handModel CONSTANT)
 
 public:
     explicit Player(QString name = "", Game *parent = nullptr);
@@ -51,6 +53,8 @@ public:
     void setName(const QString &name);
 
     virtual void setHand(const CardSet &cards) override;
+    /// The hand as a model that reports individual changes
+    HandModel *handModel() const;
 
     Team *team() const;
     virtual void setTeam(Team *team);
@@ -66,6 +70,7 @@ public slots:
     virtual void selectBid(QVariantList options) const = 0;
     virtual void selectMove(const std::vector<Card> &legalMoves) const = 0;
     virtual void removeCard(Card card) override;
+    virtual void insertCard(int index, Card card) override;
     virtual void bidSort();
     virtual void playSort(Card::Suit trumpSuit);
 
@@ -73,6 +78,7 @@ protected:
     QString m_name;
     Team *m_team;
     CardSet::SuitOrder m_suitOrder;
+    HandModel *m_handModel;
 };
 
 QDebug operator<<(QDebug dbg, const Player* player);
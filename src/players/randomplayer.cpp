@@ -18,10 +18,10 @@
  */
 
 #include "randomplayer.h"
+#include "bidheuristic.h"
+#include "trace.h"
 
 #include <QLoggingCategory>
-#include <QMap>
-#include <QVector>
 #include <QVariantList>
 
 Q_DECLARE_LOGGING_CATEGORY(klaverjasAi);
@@ -32,92 +32,9 @@ void RandomPlayer::selectMove(const std::vector<Card> &legalMoves) const
     emit moveSelected(legalMoves.at(idx));
 }
 
-/* Choose a bid from the options presented.
- *
- * The bid options are scored according to the run lengths, which give an
- * indication of how many tricks might be secured by the player.
- */
 void RandomPlayer::selectBid(QVariantList options) const
 {
+    KLAVERJAS_TRACE("ai", "RandomPlayer::selectBid");
     qCDebug(klaverjasAi) << m_name + "'s hand:" << m_hand;
-    CardSet::SortingMap map;
-    for (const Card::Suit s : Card::Suits)
-        map[s] = PlainOrder;
-
-    QVector<Card::Suit> bidOptions;
-    for (const auto &b : options) {
-        if (!b.isNull())
-            bidOptions << b.value<Card::Suit>();
-    }
-    const QMap<Card::Suit,int> strengthMap = handStrength(bidOptions);
-
-    // If we can pass, we only choose one of the options if, with that suit as
-    // trumps, our hand matches one of the following conditions:
-    //  * The strengths computed above add up to more than 40 points;
-    //  * We have the J and at least three more trump cards;
-    // otherwise choose the strongest suit.
-    const auto strengthList = strengthMap.values();
-    const auto suitCounts = m_hand.cardsPerSuit(strengthMap.keys().toVector());
-    QMap<Card::Suit,int> tempCounts;
-
-    auto maxStrength = std::max_element(strengthMap.constBegin(), strengthMap.constEnd());
-    QVector<Card::Suit> shortList;
-
-    if (*maxStrength > 40) {
-        shortList << maxStrength.key();
-        // If the top strength is greater than 40 and is not unique, pick the
-        // suit with the most cards
-        if (strengthList.count(*maxStrength) > 1) {
-            for (auto s = maxStrength + 1; s != strengthMap.constEnd(); ++s) {
-                if (*s == *maxStrength)
-                    shortList << s.key();
-            }
-
-            for (const Card::Suit s : shortList)
-                tempCounts[s] = suitCounts.value(s);
-
-            shortList.clear();
-            shortList << std::max_element(tempCounts.constBegin(), tempCounts.constEnd()).key();
-        }
-    } else {
-        for (auto count = suitCounts.constBegin(); count != suitCounts.constEnd(); ++count) {
-            if (strengthMap[count.key()] >= 20 && *count > 3)
-                tempCounts[count.key()] = *count;
-        }
-
-        if (!tempCounts.isEmpty())
-            shortList << std::max_element(tempCounts.constBegin(), tempCounts.constEnd()).key();
-    }
-
-    // Decide
-    QVariant choice;
-    if (shortList.isEmpty())
-        choice = options.last().isNull() ? options.last() : QVariant::fromValue(maxStrength.key());
-    else
-        choice = QVariant::fromValue(shortList.first());
-
-    emit bidSelected(choice);
-}
-
-// The strength is the estimated number of points that could be scored with
-// a given trump option.
-QMap<Card::Suit,int> RandomPlayer::handStrength(const QVector<Card::Suit> bidOptions) const
-{
-    QMap<Card::Suit,int> strengthMap;
-    CardSet::SortingMap sortingMap;
-    for (const Card::Suit option : bidOptions) {
-        strengthMap[option] = 0;
-        for (const Card::Suit s : Card::Suits) {
-            sortingMap[s] = rankOrder(s == option);
-        }
-        const auto runMap = m_hand.runs(sortingMap);
-        for (auto run = runMap.begin(); run != runMap.end(); ++run) {
-            const auto values = cardValues(run.key() == option);
-            for (const auto r : run.value())
-                strengthMap[option] += values[r];
-        }
-        qCDebug(klaverjasAi) << "Suit" << option << "runs" << runMap;
-    }
-    qCDebug(klaverjasAi) << "Strengths" << strengthMap;
-    return strengthMap;
+    emit bidSelected(BidHeuristic::choose(m_hand, options));
 }
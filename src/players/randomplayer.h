@@ -34,9 +34,6 @@ public:
 public slots:
     virtual void selectBid(QVariantList options) const override;
     virtual void selectMove(const std::vector<Card> &legalMoves) const override;
-
-private:
-    QMap<Card::Suit,int> handStrength(const QVector<Card::Suit> bidOptions) const;
 };
 
 #endif // RANDOMPLAYER_H
@@ -0,0 +1,37 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Command line engine for tournament managers, see EngineProtocol
+
+#include "engineprotocol.h"
+
+#include <QLoggingCategory>
+#include <QTime>
+
+#include <cstdio>
+#include <cstdlib>
+
+int main(int, char **)
+{
+    // The output is reserved for the protocol; diagnostics go to stderr
+    QLoggingCategory::setFilterRules("klaverjas.*.debug=false");
+    std::srand(QTime::currentTime().msec());
+    EngineProtocol protocol(stdin, stdout);
+    return protocol.exec();
+}
@@ -0,0 +1,302 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "engineprotocol.h"
+#include "bidheuristic.h"
+#include "notation.h"
+#include "valuefunction.h"
+#include "players/baseplayer.h"
+#include "search/searchtree.h"
+
+#include <QLoggingCategory>
+
+#include <algorithm>
+
+Q_DECLARE_LOGGING_CATEGORY(klaverjasProtocol)
+
+namespace {
+
+bool parseSeat(const QString &text, int *seat)
+{
+    bool ok;
+    *seat = text.toInt(&ok);
+    return ok && *seat >= 0 && *seat < 4;
+}
+
+// Bids and bid options are suits or "pass", which becomes a null option
+bool parseBid(const QString &text, QVariant *bid)
+{
+    Card::Suit suit;
+    if (text == "pass")
+        *bid = QVariant();
+    else if (Notation::parseSuit(text, &suit))
+        *bid = QVariant::fromValue(suit);
+    else
+        return false;
+    return true;
+}
+
+} // namespace
+
+EngineProtocol::EngineProtocol(FILE *input, FILE *output)
+    : m_input(input, QIODevice::ReadOnly)
+    , m_output(output, QIODevice::WriteOnly)
+    , m_engine(nullptr)
+    , m_trumpRule(TrumpRule::Amsterdams)
+    , m_seat(0)
+    , m_iterations(2500)
+{
+    for (int i = 0; i < 4; ++i)
+        m_players << std::make_shared<BasePlayer>();
+}
+
+int EngineProtocol::exec()
+{
+    QString line;
+    while (m_input.readLineInto(&line)) {
+        const auto command = line.simplified();
+        if (command.isEmpty())
+            continue;
+        const bool proceed = execute(command.split(' '));
+        m_output.flush();
+        if (!proceed)
+            break;
+    }
+    return 0;
+}
+
+bool EngineProtocol::execute(const QStringList &command)
+{
+    const auto name = command.first();
+    if (name == "kjp") {
+        m_output << "id name Klaverjas\n" << "id author Steven Franzen\n" << "kjpok\n";
+    } else if (name == "isready") {
+        m_output << "readyok\n";
+    } else if (name == "rules") {
+        if (command.value(1) == "amsterdams")
+            m_trumpRule = TrumpRule::Amsterdams;
+        else if (command.value(1) == "rotterdams")
+            m_trumpRule = TrumpRule::Rotterdams;
+        else
+            error("unknown rules");
+    } else if (name == "valuefunction") {
+        if (command.value(1) == "none") {
+            ValueFunction::setShared(nullptr);
+        } else {
+            const auto function = ValueFunction::load(command.mid(1).join(' '));
+            if (function)
+                ValueFunction::setShared(function);
+            else
+                error("cannot load value function");
+        }
+    } else if (name == "newround") {
+        newRound(command);
+    } else if (name == "bid") {
+        bid(command);
+    } else if (name == "contract") {
+        contract(command);
+    } else if (name == "play") {
+        play(command);
+    } else if (name == "go") {
+        go(command);
+    } else if (name == "quit") {
+        return false;
+    } else {
+        error("unknown command " + name);
+    }
+    return true;
+}
+
+// Our own cards are known; the others are handed out in order as a first guess
+void EngineProtocol::newRound(const QStringList &command)
+{
+    int seat;
+    if (command.size() != 10 || !parseSeat(command.at(1), &seat))
+        return error("expected a seat and 8 cards");
+    CardSet hand;
+    for (int i = 2; i < 10; ++i) {
+        Card card;
+        if (!Notation::parseCard(command.at(i), &card) || hand.contains(card))
+            return error("invalid card " + command.at(i));
+        hand << card;
+    }
+    QVector<Card> others;
+    for (uint i = 0; i < 32; ++i) {
+        if (!hand.contains(Card::fromId(i)))
+            others << Card::fromId(i);
+    }
+    m_seat = seat;
+    m_belief = Belief();
+    for (int p = 0, dealt = 0; p < 4; ++p) {
+        if (p == m_seat) {
+            m_players[p]->setHand(hand);
+        } else {
+            m_players[p]->setHand(others.mid(dealt, 8));
+            dealt += 8;
+        }
+    }
+    m_engine.reset();
+}
+
+void EngineProtocol::bid(const QStringList &command)
+{
+    int seat;
+    QVariant bid;
+    if (!parseSeat(command.value(1), &seat) || !parseBid(command.value(2), &bid))
+        return error("expected a seat and a bid");
+    QVariantList options;
+    for (const auto &word : command.mid(3)) {
+        QVariant option;
+        if (!parseBid(word, &option))
+            return error("invalid bid option " + word);
+        options << option;
+    }
+    m_belief.observeBid(uint(seat), options, bid);
+}
+
+void EngineProtocol::contract(const QStringList &command)
+{
+    int contractor, leader;
+    Card::Suit suit;
+    if (!parseSeat(command.value(1), &contractor) || !Notation::parseSuit(command.value(2), &suit)
+            || !parseSeat(command.value(3), &leader))
+        return error("expected contractor, suit and leader");
+    m_engine = GameEngine::create(m_players, GameEngine::Position(leader), GameEngine::Position(contractor), m_trumpRule, suit);
+    if (!m_engine)
+        return error("no round in progress");
+    m_engine->setBelief(std::make_shared<const Belief>(m_belief), Belief::Samples);
+}
+
+void EngineProtocol::play(const QStringList &command)
+{
+    int seat;
+    Card card;
+    if (!parseSeat(command.value(1), &seat) || !Notation::parseCard(command.value(2), &card))
+        return error("expected a seat and a card");
+    if (!m_engine || m_engine->isFinished() || int(m_engine->currentPlayer()) != seat)
+        return error("not the turn of seat " + command.at(1));
+    if (m_engine->cardsPlayed().contains(card))
+        return error("card already played " + command.at(2));
+    if (seat != m_seat && m_engine->hand(uint(m_seat)).contains(card))
+        return error("card held by us " + command.at(2));
+    if (seat != m_seat)
+        placeCard(seat, card);
+    // Asking for the valid moves also records what the move reveals about the
+    // player's hand
+    const auto moves = m_engine->validMoves();
+    if (seat == m_seat && std::find(moves.begin(), moves.end(), card) == moves.end())
+        return error("illegal move " + command.at(2));
+    m_engine->doMove(card);
+}
+
+/* Make the guessed hand of another player agree with a card they played. The
+ * card is swapped in from whoever was guessed to hold it, and if they did not
+ * follow suit, their cards of the suit led are swapped out for other cards.
+ */
+void EngineProtocol::placeCard(int seat, Card card)
+{
+    const auto &player = m_players[seat];
+    const auto swap = [&](int other, Card given, Card taken) {
+        CardSet hand = player->hand();
+        CardSet otherHand = m_players[other]->hand();
+        hand.remove(given);
+        hand << taken;
+        otherHand.remove(taken);
+        otherHand << given;
+        player->setHand(hand);
+        m_players[other]->setHand(otherHand);
+    };
+
+    for (int other = 0; other < 4 && !player->hand().contains(card); ++other) {
+        if (other != seat && other != m_seat && m_players[other]->hand().contains(card))
+            swap(other, player->hand().first(), card);
+    }
+    const auto &trick = m_engine->currentTrick().cards();
+    if (trick.isEmpty() || card.suit() == trick.first().suit())
+        return;
+    const auto led = trick.first().suit();
+    for (int other = 0; other < 4; ++other) {
+        if (other == seat || other == m_seat)
+            continue;
+        while (player->hand().containsSuit(led)) {
+            const auto &otherHand = m_players[other]->hand();
+            const auto replacement = std::find_if(otherHand.begin(), otherHand.end(), [&](const Card &c) {
+                return c.suit() != led;
+            });
+            if (replacement == otherHand.end())
+                break;
+            const auto given = *std::find_if(player->hand().begin(), player->hand().end(), [&](const Card &c) {
+                return c.suit() == led;
+            });
+            swap(other, given, *replacement);
+        }
+    }
+}
+
+void EngineProtocol::go(const QStringList &command)
+{
+    if (command.value(1) == "bid") {
+        QVariantList options;
+        for (const auto &word : command.mid(2)) {
+            QVariant option;
+            if (!parseBid(word, &option))
+                return error("invalid bid option " + word);
+            options << option;
+        }
+        if (options.isEmpty())
+            return error("no bid options");
+        const auto bid = BidHeuristic::choose(m_players[m_seat]->hand(), options);
+        m_output << "bestbid " << (bid.isNull() ? QStringLiteral("pass") : Notation::suit(bid.value<Card::Suit>())) << '\n';
+        return;
+    }
+    if (command.value(1) != "move")
+        return error("expected go bid or go move");
+    if (!m_engine || m_engine->isFinished() || int(m_engine->currentPlayer()) != m_seat)
+        return error("not our turn");
+
+    int iterations = m_iterations;
+    int moveTime = 0;
+    for (int i = 2; i + 1 < command.size(); i += 2) {
+        if (command.at(i) == "iterations")
+            iterations = command.at(i + 1).toInt();
+        else if (command.at(i) == "movetime")
+            moveTime = command.at(i + 1).toInt();
+    }
+    if (iterations < 1 || moveTime < 0)
+        return error("invalid search budget");
+
+    const auto root = m_engine->clone();
+    root->setMergeEquivalentMoves(true);
+    root->setEarlyTermination(true);
+    root->setValueFunction(ValueFunction::shared(), ValueFunction::PlayoutTricks);
+    SearchTree search(iterations);
+    search.setMoveTime(moveTime);
+    const Card move = search(*root);
+    const auto statistics = search.statistics();
+    const auto elapsed = std::max<qint64>(statistics.time, 1);
+    m_output << "info iterations " << statistics.iterations << " time " << statistics.time
+             << " ips " << qint64(statistics.iterations) * 1000 / elapsed << '\n';
+    qCDebug(klaverjasProtocol) << "Selected" << move;
+    m_output << "bestmove " << Notation::card(move) << '\n';
+}
+
+void EngineProtocol::error(const QString &reason)
+{
+    m_output << "info string error " << reason << '\n';
+}
@@ -0,0 +1,100 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ENGINEPROTOCOL_H
+#define ENGINEPROTOCOL_H
+
+#include "belief.h"
+#include "gameengine.h"
+#include "rules.h"
+
+#include <QStringList>
+#include <QTextStream>
+
+#include <memory>
+
+/**
+ * Text protocol for driving the AI from another process.
+ *
+ * In the manner of chess engines, the engine reads one command per line from
+ * its input and writes its responses to its output. The engine only knows its
+ * own hand and what it is told about the bids and cards played; the hands of
+ * the other players are guessed for each search iteration.
+ *
+ *      kjp                             Identify; answered by "id ..." lines
+ *                                      and "kjpok"
+ *      isready                         Answered by "readyok"
+ *      rules amsterdams|rotterdams     Set the trump rule
+ *      valuefunction <file>|none       Cut search playouts short with the
+ *                                      value function in the file
+ *      newround <seat> <cards>         Start a round holding these 8 cards in
+ *                                      the given seat (0-3)
+ *      bid <seat> <suit>|pass <options>
+ *                                      Observe a bid and the options the seat
+ *                                      had, as for go bid; the hands are
+ *                                      guessed accordingly. Without options,
+ *                                      the bid is ignored
+ *      contract <seat> <suit> <leader> Start play with the given contractor,
+ *                                      trump suit and first player
+ *      play <seat> <card>              Observe a card, including our own;
+ *                                      cards already played, or held by us
+ *                                      when played by another seat, are
+ *                                      refused
+ *      go bid <options>                Choose a bid; answered by "bestbid"
+ *      go move [iterations <n>] [movetime <ms>]
+ *                                      Search a move; answered by "info
+ *                                      iterations <n> time <ms> ips <n>" and
+ *                                      "bestmove <card>". A forced move is
+ *                                      played without a search, at 0
+ *                                      iterations
+ *      quit
+ *
+ * Suits and cards are written as described in Notation. Invalid commands are
+ * answered by "info string error <reason>".
+ */
+class EngineProtocol
+{
+public:
+    EngineProtocol(FILE *input, FILE *output);
+
+    /// Process commands until the input ends or quit is received
+    int exec();
+    /// Process a single command, returning false if it was quit
+    bool execute(const QStringList &command);
+
+private:
+    void newRound(const QStringList &command);
+    void bid(const QStringList &command);
+    void contract(const QStringList &command);
+    void play(const QStringList &command);
+    void go(const QStringList &command);
+    void placeCard(int seat, Card card);
+    void error(const QString &reason);
+
+    QTextStream m_input;
+    QTextStream m_output;
+    GameEngine::PlayerList m_players;
+    std::unique_ptr<GameEngine> m_engine;
+    Belief m_belief;
+    TrumpRule m_trumpRule;
+    int m_seat;
+    int m_iterations;
+};
+
+#endif // ENGINEPROTOCOL_H
@@ -10,9 +10,9 @@ ListView {
     orientation: ListView.Horizontal
     interactive: false
     spacing: 2
-    model: player.hand.cards
+    model: player.handModel
     delegate: CardImage {
-        card: modelData
+        card: model.card
         height: 100
         rotation: orientation == ListView.Horizontal ? 0 : 90
         MouseArea {
@@ -23,7 +23,7 @@ ListView {
             propagateComposedEvents: true
             onClicked: {
                 mArea.enabled = false;
-                player.moveSelected(modelData);
+                player.moveSelected(model.card);
             }
             onEntered: list.currentIndex = index
             Connections {
@@ -73,23 +73,23 @@ Rectangle {
             height: scoreSize
             Label {
                 id: points
-                text: modelData.points
+                text: model.points
                 fontSizeMode: Text.VerticalFit
                 leftPadding: 2
             }
             Label {
                 anchors.left: points.right
                 font: points.font
-                text: modelData.bonus == 0 ? "" : " + " + modelData.bonus
+                text: model.bonus == 0 ? "" : " + " + model.bonus
             }
             Label {
                 anchors.right: parent.right
                 font: points.font
                 rightPadding: 2
                 text: {
-                    if (modelData.wet)
+                    if (model.wet)
                         return "NAT";
-                    else if (modelData.march)
+                    else if (model.march)
                         return "PIT";
                     else
                         return "";
@@ -24,6 +24,7 @@ Item {
         anchors.centerIn: names
         delegate: CardImage {
             id: img
+            height: 100
             Connections {
                 target: game
                 onCardPlayed: {
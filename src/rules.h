@@ -5,6 +5,8 @@
 
 #include <QMap>
 
+#include <array>
+
 /// General game rules and definitions
 
 /// Rules for bidding (electing a trump suit)
@@ -73,6 +75,21 @@ inline const Card::Order &rankOrder(bool isTrump)
     return isTrump ? TrumpOrder : PlainOrder;
 }
 
+/// PlainOrder and TrumpOrder as arrays indexed by Card::rankIndex, for move
+/// generation and trick resolution
+const std::array<uchar,8> PlainRanking {{0, 1, 2, 6, 5, 4, 3, 7}};
+const std::array<uchar,8> TrumpRanking {{0, 1, 6, 4, 3, 2, 7, 5}};
+
+template<bool IsTrump> inline uchar ranking(Card::Rank rank)
+{
+    return (IsTrump ? TrumpRanking : PlainRanking)[Card::rankIndex(rank)];
+}
+
+inline uchar ranking(Card::Rank rank, bool isTrump)
+{
+    return isTrump ? ranking<true>(rank) : ranking<false>(rank);
+}
+
 /// The values of the plain (non-trump) suits
 const QMap<Card::Rank,int> PlainValues {
     {Card::Rank::Ace,   11},
@@ -0,0 +1,79 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "runtable.h"
+#include "rules.h"
+
+#include <algorithm>
+
+namespace {
+
+std::array<Card::Rank,8> makeSequence(bool isTrump)
+{
+    std::array<Card::Rank,8> sequence;
+    const auto &order = rankOrder(isTrump);
+    for (auto r = order.cbegin(); r != order.cend(); ++r)
+        sequence[7 - r.value()] = r.key();
+    return sequence;
+}
+
+/* Walk the ranks from high to low for every possible mask, counting the
+ * lengths of the runs of ranks that are present.
+ */
+RunTable makeTable(bool isTrump)
+{
+    RunTable table;
+    const auto &sequence = rankSequence(isTrump);
+    const auto &values = cardValues(isTrump);
+    for (uint mask = 0; mask < 256; ++mask) {
+        auto &info = table[mask];
+        bool inTopRun = true;
+        uchar length = 0;
+        for (const auto rank : sequence) {
+            if (mask & (1 << Card::rankIndex(rank))) {
+                ++length;
+                info.maxRun = std::max(info.maxRun, length);
+                if (inTopRun) {
+                    ++info.topRun;
+                    info.topRunValue += values[rank];
+                }
+            } else {
+                length = 0;
+                inTopRun = false;
+            }
+        }
+    }
+    return table;
+}
+
+} // namespace
+
+const RunTable &runTable(bool isTrump)
+{
+    static const RunTable PlainTable = makeTable(false);
+    static const RunTable TrumpTable = makeTable(true);
+    return isTrump ? TrumpTable : PlainTable;
+}
+
+const std::array<Card::Rank,8> &rankSequence(bool isTrump)
+{
+    static const auto PlainSequence = makeSequence(false);
+    static const auto TrumpSequence = makeSequence(true);
+    return isTrump ? TrumpSequence : PlainSequence;
+}
@@ -0,0 +1,49 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RUNTABLE_H
+#define RUNTABLE_H
+
+#include "card.h"
+
+#include <QtGlobal>
+
+#include <array>
+
+/// Run characteristics of the cards held in a single suit
+struct RunInfo
+{
+    /// The number of successive cards from the highest rank down
+    uchar topRun = 0;
+    /// The length of the longest sequence of successive cards
+    uchar maxRun = 0;
+    /// The summed card values of the top run
+    uchar topRunValue = 0;
+};
+
+/// Run information indexed by the rank mask of a suit (see CardSet::suitMask)
+using RunTable = std::array<RunInfo,256>;
+
+/// The run table for the plain or trump order, computed on first use
+const RunTable &runTable(bool isTrump);
+
+/// The ranks of the plain or trump order, from highest to lowest
+const std::array<Card::Rank,8> &rankSequence(bool isTrump);
+
+#endif // RUNTABLE_H
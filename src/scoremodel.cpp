@@ -0,0 +1,114 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "scoremodel.h"
+
+ScoreModel::ScoreModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int ScoreModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+int ScoreModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ScoreModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size())
+        return QVariant();
+    const auto &row = m_rows.at(index.row());
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case PointsColumn:
+            return row.score.wet ? QVariant("NAT") : QVariant(row.score.points);
+        case BonusColumn:
+            return row.score.march ? QVariant("PIT") : QVariant(row.score.bonus);
+        case TotalColumn:
+            return row.total;
+        }
+        return QVariant();
+    }
+    switch (role) {
+    case PointsRole:
+        return row.score.points;
+    case BonusRole:
+        return row.score.bonus;
+    case WetRole:
+        return row.score.wet;
+    case MarchRole:
+        return row.score.march;
+    case TotalRole:
+        return row.total;
+    }
+    return QVariant();
+}
+
+QVariant ScoreModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QAbstractTableModel::headerData(section, orientation, role);
+    switch (section) {
+    case PointsColumn:
+        return tr("Points");
+    case BonusColumn:
+        return tr("Bonus");
+    case TotalColumn:
+        return tr("Total");
+    }
+    return QVariant();
+}
+
+QHash<int,QByteArray> ScoreModel::roleNames() const
+{
+    return {
+        {PointsRole, "points"},
+        {BonusRole, "bonus"},
+        {WetRole, "wet"},
+        {MarchRole, "march"},
+        {TotalRole, "total"}
+    };
+}
+
+void ScoreModel::append(const RoundScore &score)
+{
+    const int row = m_rows.size();
+    beginInsertRows(QModelIndex(), row, row);
+    m_rows.append({score, total() + score.sum()});
+    endInsertRows();
+}
+
+void ScoreModel::clear()
+{
+    if (m_rows.isEmpty())
+        return;
+    beginRemoveRows(QModelIndex(), 0, m_rows.size() - 1);
+    m_rows.clear();
+    endRemoveRows();
+}
+
+uint ScoreModel::total() const
+{
+    return m_rows.isEmpty() ? 0 : m_rows.last().total;
+}
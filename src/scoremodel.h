@@ -0,0 +1,78 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SCOREMODEL_H
+#define SCOREMODEL_H
+
+#include "scores.h"
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+/**
+ * Table model of the round scores of a team.
+ *
+ * Each round is a row holding the points, the bonus and the running total up
+ * to and including that round. Adding a round only inserts its row, so views
+ * do not have to rebuild the earlier rounds. QML views can use the roles
+ * points, bonus, wet, march and total.
+ */
+class ScoreModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        PointsColumn,
+        BonusColumn,
+        TotalColumn,
+        ColumnCount
+    };
+    enum Roles {
+        PointsRole = Qt::UserRole + 1,
+        BonusRole,
+        WetRole,
+        MarchRole,
+        TotalRole
+    };
+
+    explicit ScoreModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    QHash<int,QByteArray> roleNames() const override;
+
+    void append(const RoundScore &score);
+    void clear();
+    /// The running total after the last round
+    uint total() const;
+
+private:
+    struct Row
+    {
+        RoundScore score;
+        uint total;
+    };
+
+    QVector<Row> m_rows;
+};
+
+#endif // SCOREMODEL_H
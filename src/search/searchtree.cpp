@@ -0,0 +1,786 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "searchtree.h"
+#include "statequeue.h"
+#include "gameengine.h"
+#include "trace.h"
+
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+Q_DECLARE_LOGGING_CATEGORY(klaverjasAi);
+
+namespace {
+
+// Pondering threads work in slices of this many milliseconds and then pause
+// to keep to their share of a core
+const int PonderSlice = 20;
+
+const int MaxThreads = 64;
+
+// A thread for each tree that ponders
+class PonderPool : public QThreadPool
+{
+public:
+    PonderPool()
+    {
+        setMaxThreadCount(MaxThreads);
+    }
+};
+
+QThreadPool *ponderPool()
+{
+    static PonderPool pool;
+    return &pool;
+}
+
+// The cores all pondering threads may use together, 0 if pondering is off,
+// and the number of threads pondering
+std::atomic<qreal> ponderLoad(0);
+std::atomic<int> ponderThreads(0);
+const int CacheLine = 64;
+// The smallest tree a memory limit allows, which is also enough to keep all
+// children of the root when pruning to half of it
+const qint64 MinimumNodes = 1024;
+
+// Helper threads of parallel searches
+class SearchPool : public QThreadPool
+{
+public:
+    SearchPool()
+    {
+        setMaxThreadCount(MaxThreads);
+    }
+};
+
+QThreadPool *searchPool()
+{
+    static SearchPool pool;
+    return &pool;
+}
+
+// Producers of determinised states get a pool of their own, so that they
+// never keep helper threads from starting
+QThreadPool *producerPool()
+{
+    static SearchPool pool;
+    return &pool;
+}
+
+// How long a producer waits for room in a full queue before checking whether
+// the search is over, in milliseconds
+const int ProducerWait = 5;
+
+class FunctionTask : public QRunnable
+{
+public:
+    explicit FunctionTask(std::function<void()> function)
+        : m_function(std::move(function))
+    {
+    }
+
+    void run() override
+    {
+        m_function();
+    }
+
+private:
+    std::function<void()> m_function;
+};
+
+inline void atomicAdd(std::atomic<qreal> &value, qreal delta)
+{
+    qreal expected = value.load(std::memory_order_relaxed);
+    while (!value.compare_exchange_weak(expected, expected + delta, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+/* Nodes take one cache line each and come from the tree's NodePool. Moves are
+ * Card ids, and the cards that have a child are also kept in a mask, so the
+ * untried moves of a determinisation follow from its move mask at once. Children form a list that threads only
+ * ever prepend to, so it can be read while it grows; a move is added to the
+ * mask after its child.
+ */
+struct alignas(CacheLine) SearchTree::Node
+{
+    Node(uint move, uint playerJustMoved, Node *parent)
+        : parent(parent)
+        , firstChild(nullptr)
+        , nextSibling(nullptr)
+        , score(0)
+        , visits(0)
+        , available(1)
+        , childMask(0)
+        , move(uchar(move))
+        , playerJustMoved(uchar(playerJustMoved))
+    {
+    }
+
+    // Search the children from first up to, but not including, last
+    static Node *find(Node *first, const Node *last, uint move)
+    {
+        for (Node *child = first; child != last; child = child->nextSibling) {
+            if (child->move == move)
+                return child;
+        }
+        return nullptr;
+    }
+
+    Node *findChild(uint move) const
+    {
+        return find(firstChild, nullptr, move);
+    }
+
+    // Add a child for the move, or return the one another thread added first;
+    // the tree's node count is increased if the child is new
+    Node *addChild(uint move, uint player, NodePool &pool, std::atomic<qint64> &nodeCount);
+
+    qint64 subtreeSize() const
+    {
+        qint64 size = 1;
+        for (const Node *child = firstChild; child; child = child->nextSibling)
+            size += child->subtreeSize();
+        return size;
+    }
+
+    // Unlink a child, which must not be in use by other threads
+    void removeChild(Node *child)
+    {
+        if (firstChild == child) {
+            firstChild = child->nextSibling;
+        } else {
+            Node *previous = firstChild;
+            while (previous->nextSibling != child)
+                previous = previous->nextSibling;
+            previous->nextSibling = child->nextSibling;
+        }
+        childMask.fetch_and(~(quint32(1) << child->move));
+        child->parent = nullptr;
+        child->nextSibling = nullptr;
+    }
+
+    Node *parent;
+    std::atomic<Node*> firstChild;
+    Node *nextSibling;
+    std::atomic<qreal> score;
+    std::atomic<int> visits;
+    std::atomic<int> available;
+    std::atomic<quint32> childMask;
+    uchar move;
+    uchar playerJustMoved;
+};
+
+/* Nodes are carved out of aligned slabs, which are only freed with the pool,
+ * so each node costs exactly its cache line plus a share of one extra line per
+ * slab. Released nodes are kept for reuse in a list linked through their
+ * siblings. Expansions are rare next to the rest of an iteration, so a mutex
+ * suffices.
+ */
+class SearchTree::NodePool
+{
+public:
+    static const int SlabNodes = 1024;
+
+    NodePool()
+        : m_slab(nullptr)
+        , m_free(nullptr)
+        , m_used(SlabNodes)
+    {
+    }
+
+    ~NodePool()
+    {
+        for (void *block : m_blocks)
+            ::operator delete(block);
+    }
+
+    NodePool(const NodePool &) = delete;
+    NodePool &operator=(const NodePool &) = delete;
+
+    Node *allocate(uint move, uint playerJustMoved, Node *parent)
+    {
+        void *address;
+        {
+            QMutexLocker lock(&m_mutex);
+            if (m_free) {
+                address = m_free;
+                m_free = m_free->nextSibling;
+            } else {
+                if (m_used == SlabNodes)
+                    addSlab();
+                address = m_slab + m_used++;
+            }
+        }
+        return new (address) Node(move, playerJustMoved, parent);
+    }
+
+    // Free a node and its subtree
+    void release(Node *node)
+    {
+        QMutexLocker lock(&m_mutex);
+        const std::function<void(Node *)> push = [&](Node *n) {
+            Node *next;
+            for (Node *child = n->firstChild; child; child = next) {
+                next = child->nextSibling;
+                push(child);
+            }
+            n->nextSibling = m_free;
+            m_free = n;
+        };
+        push(node);
+    }
+
+    // The memory taken by a slab, and by all slabs
+    static qint64 slabBytes()
+    {
+        return SlabNodes * qint64(sizeof(Node)) + CacheLine;
+    }
+
+    qint64 bytes() const
+    {
+        return qint64(m_blocks.size()) * slabBytes();
+    }
+
+private:
+    void addSlab()
+    {
+        void *block = ::operator new(SlabNodes * sizeof(Node) + CacheLine);
+        m_blocks.push_back(block);
+        m_slab = reinterpret_cast<Node *>((quintptr(block) + CacheLine - 1) & ~quintptr(CacheLine - 1));
+        m_used = 0;
+    }
+
+    QMutex m_mutex;
+    std::vector<void *> m_blocks;
+    Node *m_slab;
+    Node *m_free;
+    int m_used;
+
+    // Nodes are reused without running a destructor
+    static_assert(std::is_trivially_destructible<Node>::value, "Nodes must be trivially destructible");
+};
+
+SearchTree::Node *SearchTree::Node::addChild(uint move, uint player, NodePool &pool, std::atomic<qint64> &nodeCount)
+{
+    Node *head = firstChild;
+    Node *existing = find(head, nullptr, move);
+    if (existing)
+        return existing;
+    Node *child = pool.allocate(move, player, this);
+    child->nextSibling = head;
+    while (!firstChild.compare_exchange_weak(child->nextSibling, child)) {
+        existing = find(child->nextSibling, head, move);
+        if (existing) {
+            pool.release(child);
+            return existing;
+        }
+        head = child->nextSibling;
+    }
+    childMask.fetch_or(quint32(1) << move);
+    ++nodeCount;
+    return child;
+}
+
+/* A pondering session is shared with its task, which only uses the tree after
+ * marking the session as started, and never if it was stopped first. The
+ * session therefore tells stopPondering whether it must wait for the task.
+ */
+struct SearchTree::Ponder
+{
+    Ponder()
+        : isStarted(false)
+        , isStopped(false)
+    {
+    }
+
+    QMutex mutex;
+    bool isStarted;
+    std::atomic<bool> isStopped;
+    // Released on stopping, to cut a pause short
+    QSemaphore stop;
+    QSemaphore finished;
+};
+
+class PonderTask : public QRunnable
+{
+public:
+    PonderTask(SearchTree *tree, std::shared_ptr<SearchTree::Ponder> ponder, std::unique_ptr<GameEngine> rootState, uint observer)
+        : m_tree(tree)
+        , m_ponder(std::move(ponder))
+        , m_rootState(std::move(rootState))
+        , m_observer(observer)
+    {
+    }
+
+    void run() override
+    {
+        {
+            QMutexLocker lock(&m_ponder->mutex);
+            if (m_ponder->isStopped)
+                return;
+            m_ponder->isStarted = true;
+        }
+        m_tree->ponderLoop(*m_rootState, m_observer, *m_ponder);
+        m_ponder->finished.release();
+    }
+
+private:
+    SearchTree *m_tree;
+    std::shared_ptr<SearchTree::Ponder> m_ponder;
+    std::unique_ptr<GameEngine> m_rootState;
+    uint m_observer;
+};
+
+SearchTree::SearchTree(int iterations, qreal exploration)
+    : m_root(nullptr)
+    , m_trumpSuit(Card::Suit::Clubs)
+    , m_observer(0)
+    , m_iterations(iterations)
+    , m_moveTime(0)
+    , m_threads(1)
+    , m_producers(0)
+    , m_maxNodes(0)
+    , m_nodeCount(0)
+    , m_statistics()
+    , m_exploration(exploration)
+    , m_random(std::random_device()())
+    , m_pool(new NodePool)
+{
+}
+
+SearchTree::~SearchTree()
+{
+    stopPondering();
+}
+
+Card SearchTree::operator()(const GameEngine &rootState)
+{
+    KLAVERJAS_TRACE("ai", "SearchTree::search");
+    const auto moves = rootState.validMoveMask();
+    if ((moves & (moves - 1)) == 0)
+        return Card::fromId(qCountTrailingZeroBits(moves));
+
+    stopPondering();
+    setRoot(rootState, rootState.currentPlayer());
+    const int inherited = m_root->visits;
+    QElapsedTimer timer;
+    timer.start();
+    std::atomic<int> remaining(m_iterations);
+    std::atomic<int> done(0);
+    std::atomic<bool> isExhausted(false);
+    std::atomic<qint64> determinisations(0);
+    std::atomic<qint64> producerStalls(0);
+    std::atomic<qint64> consumerStalls(0);
+
+    // Producers run until the search is over. A producer that finds the queue
+    // full sleeps until a search thread takes a state, or a while at most.
+    StateQueue queue(4 * std::max(m_threads, m_producers));
+    QSemaphore producersFinished;
+    QSemaphore taken;
+    std::atomic<int> waitingProducers(0);
+    for (int i = 0; i < m_producers; ++i) {
+        const auto seed = m_random();
+        producerPool()->start(new FunctionTask([&, seed]{
+            std::mt19937 random(seed);
+            std::unique_ptr<GameEngine> state;
+            while (!isExhausted) {
+                if (!state)
+                    state = rootState.determinisedClone(m_observer, random);
+                if (queue.push(state)) {
+                    ++determinisations;
+                    continue;
+                }
+                ++producerStalls;
+                ++waitingProducers;
+                taken.tryAcquire(1, ProducerWait);
+                --waitingProducers;
+            }
+            producersFinished.release();
+        }));
+    }
+
+    const auto work = [&](std::mt19937 &random) {
+        while (!isFull()) {
+            const bool hasBudget = m_moveTime > 0 ? timer.elapsed() < m_moveTime : remaining-- > 0;
+            if (!hasBudget) {
+                isExhausted = true;
+                return;
+            }
+            auto state = m_producers > 0 ? queue.pop() : nullptr;
+            if (state && waitingProducers > 0)
+                taken.release();
+            if (!state) {
+                if (m_producers > 0)
+                    ++consumerStalls;
+                state = rootState.determinisedClone(m_observer, random);
+            }
+            iterate(*state, random);
+            ++done;
+        }
+    };
+    // The threads stop when the tree is full, so that it can be pruned
+    while (true) {
+        const int helpers = std::max(m_moveTime > 0 ? m_threads - 1 : std::min(m_threads, remaining.load()) - 1, 0);
+        QSemaphore finished;
+        for (int i = 0; i < helpers; ++i) {
+            const auto seed = m_random();
+            searchPool()->start(new FunctionTask([&, seed]{
+                std::mt19937 random(seed);
+                work(random);
+                finished.release();
+            }));
+        }
+        work(m_random);
+        finished.acquire(helpers);
+        if (isExhausted)
+            break;
+        prune();
+    }
+    taken.release(m_producers);
+    producersFinished.acquire(m_producers);
+    m_statistics.iterations = done;
+    m_statistics.time = timer.elapsed();
+    m_statistics.determinisations = determinisations;
+    m_statistics.producerStalls = producerStalls;
+    m_statistics.consumerStalls = consumerStalls;
+    m_statistics.rootVisits = m_root->visits;
+    m_statistics.nodes = m_nodeCount;
+    m_statistics.memory = m_pool->bytes();
+    qCDebug(klaverjasAi) << "Search reused" << inherited << "of" << m_statistics.rootVisits << "iterations, tree of"
+        << m_statistics.nodes << "nodes," << m_statistics.memory / 1024 << "KiB";
+    if (m_producers > 0)
+        qCDebug(klaverjasAi) << "Producers determinised" << m_statistics.determinisations << "states for"
+            << m_statistics.iterations << "iterations in" << m_statistics.time << "ms, stalled"
+            << m_statistics.producerStalls << "times on a full queue and searchers" << m_statistics.consumerStalls
+            << "times on an empty one";
+
+    // Children of a reused root may stem from merged moves that are no longer
+    // offered, so only consider the current ones
+    const Node *best = nullptr;
+    for (const Node *child = m_root->firstChild; child; child = child->nextSibling) {
+        if (!(moves & (quint32(1) << child->move)))
+            continue;
+        if (!best || child->visits > best->visits)
+            best = child;
+    }
+    return Card::fromId(best ? best->move : qCountTrailingZeroBits(moves));
+}
+
+void SearchTree::setRoot(const GameEngine &rootState, uint observer)
+{
+    if (descend(rootState, observer))
+        return;
+    m_pool.reset(new NodePool);
+    m_root = m_pool->allocate(0, 0, nullptr);
+    m_nodeCount = 1;
+    m_statistics.prunes = 0;
+    m_rootCards = rootState.cardsPlayed();
+    m_trumpSuit = rootState.trumpSuit();
+    m_observer = observer;
+}
+
+/* The observer knows the state of the root up to the cards held by the other
+ * players, so it is enough to compare the trump suit and the cards played to
+ * recognise a later state of the same round.
+ */
+bool SearchTree::descend(const GameEngine &rootState, uint observer)
+{
+    if (!m_root || rootState.trumpSuit() != m_trumpSuit || observer != m_observer)
+        return false;
+    const auto cards = rootState.cardsPlayed();
+    if (cards.size() < m_rootCards.size() || !std::equal(m_rootCards.cbegin(), m_rootCards.cend(), cards.cbegin()))
+        return false;
+
+    Node *node = m_root;
+    for (auto c = cards.begin() + m_rootCards.size(); c < cards.end(); ++c) {
+        node = node->findChild(c->id());
+        if (!node)
+            return false;
+    }
+    if (node == m_root)
+        return true;
+
+    // Detach the new root from its parent before the rest of the tree is freed
+    node->parent->removeChild(node);
+    m_pool->release(m_root);
+    m_root = node;
+    m_nodeCount = m_root->subtreeSize();
+    m_rootCards = cards;
+    return true;
+}
+
+void SearchTree::reset()
+{
+    stopPondering();
+    m_root = nullptr;
+    m_pool.reset(new NodePool);
+    m_nodeCount = 0;
+    m_rootCards.clear();
+}
+
+bool SearchTree::isFull() const
+{
+    return m_maxNodes > 0 && m_nodeCount >= m_maxNodes;
+}
+
+/* A child never has more visits than its parent, so removing every node with
+ * at most a given number of visits removes whole subtrees. The number is the
+ * smallest that brings the tree down to half of its limit.
+ */
+void SearchTree::prune()
+{
+    KLAVERJAS_TRACE("ai", "SearchTree::prune");
+    const qint64 excess = m_nodeCount - m_maxNodes / 2;
+    if (excess <= 0)
+        return;
+    std::vector<int> visits;
+    visits.reserve(m_nodeCount);
+    const std::function<void(const Node *)> collect = [&](const Node *node) {
+        for (const Node *child = node->firstChild; child; child = child->nextSibling) {
+            visits.push_back(child->visits);
+            collect(child);
+        }
+    };
+    for (const Node *child = m_root->firstChild; child; child = child->nextSibling)
+        collect(child);
+    if (visits.empty())
+        return;
+    const auto nth = visits.begin() + std::min<qint64>(excess, visits.size()) - 1;
+    std::nth_element(visits.begin(), nth, visits.end());
+    const int threshold = *nth;
+
+    const std::function<qint64(Node *)> removeBelow = [&](Node *node) {
+        qint64 removed = 0;
+        Node *next;
+        for (Node *child = node->firstChild; child; child = next) {
+            next = child->nextSibling;
+            if (child->visits <= threshold) {
+                removed += child->subtreeSize();
+                node->removeChild(child);
+                m_pool->release(child);
+            } else {
+                removed += removeBelow(child);
+            }
+        }
+        return removed;
+    };
+    qint64 removed = 0;
+    for (Node *child = m_root->firstChild; child; child = child->nextSibling)
+        removed += removeBelow(child);
+    m_nodeCount -= removed;
+    ++m_statistics.prunes;
+    qCDebug(klaverjasAi) << "Pruned" << removed << "nodes with at most" << threshold << "visits";
+}
+
+void SearchTree::ponder(std::unique_ptr<GameEngine> rootState, uint observer)
+{
+    stopPondering();
+    if (ponderLoad == 0 || !rootState->validMoveMask())
+        return;
+    m_ponder = std::make_shared<Ponder>();
+    ponderPool()->start(new PonderTask(this, m_ponder, std::move(rootState), observer));
+}
+
+void SearchTree::stopPondering()
+{
+    if (!m_ponder)
+        return;
+    bool isStarted;
+    {
+        QMutexLocker lock(&m_ponder->mutex);
+        m_ponder->isStopped = true;
+        isStarted = m_ponder->isStarted;
+    }
+    m_ponder->stop.release();
+    if (isStarted)
+        m_ponder->finished.acquire();
+    m_ponder.reset();
+}
+
+/* The load is shared equally by the trees that ponder at the time, so each
+ * thread pauses as much as needed to keep to its share of a core. The pause
+ * ends early when pondering is stopped.
+ */
+void SearchTree::ponderLoop(const GameEngine &rootState, uint observer, Ponder &ponder)
+{
+    KLAVERJAS_TRACE("ai", "SearchTree::ponder");
+    setRoot(rootState, observer);
+    ++ponderThreads;
+    QElapsedTimer timer;
+    const auto share = []{ return std::min<qreal>(ponderLoad / std::max(ponderThreads.load(), 1), 1); };
+    for (qreal duty = share(); duty > 0 && !ponder.isStopped; duty = share()) {
+        timer.start();
+        while (!ponder.isStopped && timer.elapsed() < PonderSlice) {
+            if (isFull())
+                prune();
+            iterate(*rootState.determinisedClone(m_observer, m_random), m_random);
+        }
+        if (duty < 1)
+            ponder.stop.tryAcquire(1, int(timer.elapsed() * (1 - duty) / duty));
+    }
+    --ponderThreads;
+    qCDebug(klaverjasAi) << "Pondered" << m_root->visits.load() << "iterations";
+}
+
+void SearchTree::setPonderLoad(int percent)
+{
+    const int cores = std::max(QThread::idealThreadCount(), 1);
+    ponderLoad = cores * qBound(0, percent, 100) / 100.0;
+}
+
+// The UCB1 choice among the children whose moves are available in this
+// determinisation, each of which has its availability counted
+SearchTree::Node *SearchTree::selectChild(Node *node, quint32 moves) const
+{
+    Node *best = nullptr;
+    qreal bestScore = -1;
+    for (Node *child = node->firstChild; child; child = child->nextSibling) {
+        if (!(moves & (quint32(1) << child->move)))
+            continue;
+        // A child that another thread has only just added may have no visits
+        const qreal visits = std::max(child->visits.load(), 1);
+        const qreal score = child->score / visits
+            + m_exploration * std::sqrt(std::log(qreal(child->available)) / visits);
+        if (score > bestScore) {
+            best = child;
+            bestScore = score;
+        }
+        ++child->available;
+    }
+    return best;
+}
+
+/* Visits are counted on the way down and scores on the way back, so until an
+ * iteration finishes, the nodes on its path look like they lost a playout.
+ */
+void SearchTree::iterate(GameEngine &state, std::mt19937 &random)
+{
+    // A random card id from a non-empty mask
+    const auto pick = [&](quint32 mask) {
+        for (auto n = random() % qPopulationCount(mask); n > 0; --n)
+            mask &= mask - 1;
+        return uint(qCountTrailingZeroBits(mask));
+    };
+
+    Node *node = m_root;
+    ++node->visits;
+    auto moves = state.validMoveMask();
+    quint32 untried = 0;
+
+    // Select until a move is found that has not been tried from this node
+    while (moves && !(untried = moves & ~node->childMask.load())) {
+        node = selectChild(node, moves);
+        ++node->visits;
+        state.doMove(Card::fromId(node->move));
+        moves = state.validMoveMask();
+    }
+
+    // Expand
+    if (moves) {
+        const auto move = pick(untried);
+        node = node->addChild(move, state.currentPlayer(), *m_pool, m_nodeCount);
+        ++node->visits;
+        state.doMove(Card::fromId(move));
+        moves = state.validMoveMask();
+    }
+
+    // Simulate
+    while (moves) {
+        state.doMove(Card::fromId(pick(moves)));
+        moves = state.validMoveMask();
+    }
+
+    // Backpropagate
+    for (; node; node = node->parent)
+        atomicAdd(node->score, state.getResult(node->playerJustMoved));
+}
+
+int SearchTree::iterations() const
+{
+    return m_iterations;
+}
+
+void SearchTree::setIterations(int iterations)
+{
+    m_iterations = iterations;
+}
+
+int SearchTree::threads() const
+{
+    return m_threads;
+}
+
+void SearchTree::setThreads(int threads)
+{
+    m_threads = qBound(1, threads, MaxThreads);
+}
+
+std::size_t SearchTree::nodeSize()
+{
+    return sizeof(Node);
+}
+
+int SearchTree::producers() const
+{
+    return m_producers;
+}
+
+void SearchTree::setProducers(int producers)
+{
+    m_producers = qBound(0, producers, MaxThreads);
+}
+
+void SearchTree::setMoveTime(int milliseconds)
+{
+    m_moveTime = milliseconds;
+}
+
+/* The tree is allocated in whole slabs, and each search thread may add a node
+ * after the tree is full, so the nodes must leave room for those in the last
+ * slab that fits.
+ */
+void SearchTree::setMemoryLimit(qint64 bytes)
+{
+    const qint64 nodes = bytes / NodePool::slabBytes() * NodePool::SlabNodes - MaxThreads;
+    m_maxNodes = bytes > 0 ? std::max(nodes, MinimumNodes) : 0;
+}
+
+SearchTree::Statistics SearchTree::statistics() const
+{
+    return m_statistics;
+}
@@ -0,0 +1,178 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef SEARCHTREE_H
+#define SEARCHTREE_H
+
+#include "card.h"
+
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+#include <random>
+
+class GameEngine;
+
+/**
+ * Single observer information set MCTS that keeps its tree between moves.
+ *
+ * The search is specialised to the game: moves are Card ids, the moves of a
+ * state come from GameEngine::validMoveMask and each node takes a single
+ * cache line.
+ *
+ * Each search runs a fixed number of iterations from the given state, like
+ * ISMCTS::SOSolver. Afterwards, the tree is kept. If the next state follows
+ * from the previous one by the cards played since, the search descends to the
+ * node reached by those cards and continues from there, so later decisions in
+ * a round also get the iterations spent on earlier ones. If any of the cards
+ * is missing from the tree, or the state belongs to another round or player,
+ * the search starts over. Call reset when a new round starts.
+ *
+ * A search can run on several threads that share the tree. The statistics
+ * of the nodes are atomic and children are added without locking, and each
+ * thread counts its visit to a node before the result is known, as a virtual
+ * loss, so that threads tend to explore different paths. Every iteration
+ * determinises its own copy of the state by default.
+ *
+ * Determinisation can be split off into a pipeline stage: producer threads
+ * then fill a StateQueue with determinised states, which the search threads
+ * take from. A search thread that finds the queue empty determinises a state
+ * itself, and the statistics count how often each stage had to wait for the
+ * other, so the number of producers can be balanced against the threads.
+ *
+ * The memory of the tree can be limited. When the tree reaches the limit,
+ * the least visited subtrees below the moves of the root are removed, and
+ * their moves are expanded afresh if they are selected again.
+ *
+ * The tree can also grow in the background while another player is to move,
+ * see ponder. Pondering runs on a shared thread pool whose load is limited by
+ * setPonderLoad, and stops before the tree is searched or reset.
+ */
+class SearchTree
+{
+public:
+    struct Statistics
+    {
+        /// Iterations run by the last search
+        int iterations;
+        /// Milliseconds taken by the last search
+        qint64 time;
+        /// States determinised by producers in the last search, and the times
+        /// a producer found the queue full and a search thread found it empty
+        qint64 determinisations;
+        qint64 producerStalls;
+        qint64 consumerStalls;
+        /// Iterations the last decision was based on, including those
+        /// inherited from earlier searches
+        int rootVisits;
+        /// The size of the tree after the last search
+        qint64 nodes;
+        qint64 memory;
+        /// Times the tree was pruned since the round started or the tree was
+        /// discarded
+        int prunes;
+    };
+
+    explicit SearchTree(int iterations = 2500, qreal exploration = 0.7);
+    ~SearchTree();
+
+    /// Search the given state and return the most visited move
+    Card operator()(const GameEngine &rootState);
+    /// Discard the tree
+    void reset();
+    /**
+     * Search the given state in the background on behalf of the observer,
+     * until stopPondering is called.
+     *
+     * A later search from a state that follows from this one continues with
+     * the subtree of the moves played in the meantime.
+     */
+    void ponder(std::unique_ptr<GameEngine> rootState, uint observer);
+    /// Stop pondering and wait until the tree is no longer in use
+    void stopPondering();
+    /**
+     * Limit pondering to the given share of the processor, in percent.
+     *
+     * Every tree that ponders gets a thread of its own, and the threads pause
+     * regularly to share the load between them. At 0, which is the default,
+     * ponder does nothing and pondering in progress ends.
+     */
+    static void setPonderLoad(int percent);
+
+    int iterations() const;
+    void setIterations(int iterations);
+    /// Search for this many milliseconds instead of a number of iterations,
+    /// if positive
+    void setMoveTime(int milliseconds);
+    int threads() const;
+    /// Share the iterations of a search among this many threads, at most 64
+    void setThreads(int threads);
+    int producers() const;
+    /// Determinise states for the search threads on this many other threads, at
+    /// most 64 and 0 by default
+    void setProducers(int producers);
+    /**
+     * Limit the memory taken by the tree to this many bytes, or 0 for no
+     * limit.
+     *
+     * Nodes are allocated in slabs of 64 KiB, and the limit counts whole
+     * slabs. When it is reached, the tree is pruned to half of it. The tree
+     * keeps at least a thousand nodes, even if that exceeds the limit.
+     */
+    void setMemoryLimit(qint64 bytes);
+    /// The memory taken by a node of the tree, in bytes
+    static std::size_t nodeSize();
+    Statistics statistics() const;
+
+private:
+    struct Node;
+    class NodePool;
+    struct Ponder;
+    friend class PonderTask;
+
+    void setRoot(const GameEngine &rootState, uint observer);
+    bool descend(const GameEngine &rootState, uint observer);
+    bool isFull() const;
+    void prune();
+    void ponderLoop(const GameEngine &rootState, uint observer, Ponder &ponder);
+    Node *selectChild(Node *node, quint32 moves) const;
+    void iterate(GameEngine &state, std::mt19937 &random);
+
+    // Owned by m_pool
+    Node *m_root;
+    // The cards played, trump suit and observing player at the root
+    QVector<Card> m_rootCards;
+    Card::Suit m_trumpSuit;
+    uint m_observer;
+    int m_iterations;
+    int m_moveTime;
+    int m_threads;
+    int m_producers;
+    qint64 m_maxNodes;
+    std::atomic<qint64> m_nodeCount;
+    Statistics m_statistics;
+    qreal m_exploration;
+    std::mt19937 m_random;
+    std::unique_ptr<NodePool> m_pool;
+    std::shared_ptr<Ponder> m_ponder;
+};
+
+#endif // SEARCHTREE_H
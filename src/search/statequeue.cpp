@@ -0,0 +1,92 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "statequeue.h"
+#include "gameengine.h"
+
+/* Cell i starts with sequence number i. A producer that claims position p of
+ * the tail finds sequence p in a free cell and leaves p + 1; a consumer that
+ * claims position p of the head finds p + 1 in a filled cell and leaves
+ * p + capacity, freeing the cell for the producer of the next lap.
+ */
+StateQueue::StateQueue(std::size_t capacity)
+    : m_mask(2)
+    , m_head(0)
+    , m_tail(0)
+{
+    while (m_mask < capacity)
+        m_mask <<= 1;
+    m_cells.reset(new Cell[m_mask]);
+    for (std::size_t i = 0; i < m_mask; ++i) {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        m_cells[i].state = nullptr;
+    }
+    --m_mask;
+}
+
+StateQueue::~StateQueue()
+{
+    while (pop()) {
+    }
+}
+
+bool StateQueue::push(std::unique_ptr<GameEngine> &state)
+{
+    Cell *cell;
+    auto position = m_tail.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &m_cells[position & m_mask];
+        const auto sequence = cell->sequence.load(std::memory_order_acquire);
+        const auto difference = qintptr(sequence) - qintptr(position);
+        if (difference == 0) {
+            if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        } else if (difference < 0) {
+            return false;
+        } else {
+            position = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+    cell->state = state.release();
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+std::unique_ptr<GameEngine> StateQueue::pop()
+{
+    Cell *cell;
+    auto position = m_head.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &m_cells[position & m_mask];
+        const auto sequence = cell->sequence.load(std::memory_order_acquire);
+        const auto difference = qintptr(sequence) - qintptr(position + 1);
+        if (difference == 0) {
+            if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        } else if (difference < 0) {
+            return nullptr;
+        } else {
+            position = m_head.load(std::memory_order_relaxed);
+        }
+    }
+    std::unique_ptr<GameEngine> state(cell->state);
+    cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+    return state;
+}
@@ -0,0 +1,72 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef STATEQUEUE_H
+#define STATEQUEUE_H
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+class GameEngine;
+
+/**
+ * Bounded lock-free queue of game states for any number of producers and
+ * consumers.
+ *
+ * The queue is a ring of cells that each carry a sequence number, which tells
+ * a producer whether the cell is free and a consumer whether it is filled for
+ * the current lap, so both only contend on their own end of the ring. It is
+ * used to pass determinised states from the threads that generate them to the
+ * threads that search them, see SearchTree::setProducers.
+ */
+class StateQueue
+{
+public:
+    /// A queue holding up to the given number of states, rounded up to a
+    /// power of two
+    explicit StateQueue(std::size_t capacity);
+    ~StateQueue();
+
+    StateQueue(const StateQueue &) = delete;
+    StateQueue &operator=(const StateQueue &) = delete;
+
+    /// Add the state, unless the queue is full; returns whether it was taken
+    bool push(std::unique_ptr<GameEngine> &state);
+    /// Take the oldest state, or nullptr if the queue is empty
+    std::unique_ptr<GameEngine> pop();
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        GameEngine *state;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    std::size_t m_mask;
+    // The ends are written by different threads, so keep them apart
+    alignas(64) std::atomic<std::size_t> m_head;
+    alignas(64) std::atomic<std::size_t> m_tail;
+};
+
+#endif // STATEQUEUE_H
@@ -0,0 +1,103 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "suitpermutation.h"
+
+namespace {
+
+std::array<uchar,4> suitMasks(const CardSet &hand)
+{
+    std::array<uchar,4> masks;
+    for (const auto s : Card::Suits)
+        masks[Card::suitIndex(s)] = hand.suitMask(s);
+    return masks;
+}
+
+} // namespace
+
+SuitPermutation::SuitPermutation()
+    : m_map {{0, 1, 2, 3}}
+{
+}
+
+Card::Suit SuitPermutation::map(Card::Suit suit) const
+{
+    return Card::Suit(m_map[Card::suitIndex(suit)] << 4);
+}
+
+Card SuitPermutation::map(Card card) const
+{
+    return Card(map(card.suit()), card.rank());
+}
+
+CardSet SuitPermutation::map(const CardSet &cards) const
+{
+    CardSet result;
+    result.reserve(cards.size());
+    for (const auto &c : cards)
+        result.append(map(c));
+    return result;
+}
+
+std::vector<Card> SuitPermutation::map(const std::vector<Card> &cards) const
+{
+    std::vector<Card> result;
+    result.reserve(cards.size());
+    for (const auto &c : cards)
+        result.emplace_back(map(c));
+    return result;
+}
+
+SuitPermutation SuitPermutation::inverse() const
+{
+    SuitPermutation inverse;
+    for (uchar s = 0; s < 4; ++s)
+        inverse.m_map[m_map[s]] = s;
+    return inverse;
+}
+
+bool SuitPermutation::isIdentity() const
+{
+    return *this == SuitPermutation();
+}
+
+bool SuitPermutation::operator==(const SuitPermutation &other) const
+{
+    return m_map == other.m_map;
+}
+
+SuitPermutation SuitPermutation::canonical(const CardSet &hand)
+{
+    return fromSignatures(suitMasks(hand));
+}
+
+SuitPermutation SuitPermutation::canonical(const CardSet &hand, Card::Suit trumpSuit)
+{
+    return fromSignatures(suitMasks(hand), Card::suitIndex(trumpSuit));
+}
+
+quint32 SuitPermutation::canonicalKey(const CardSet &hand, Card::Suit trumpSuit)
+{
+    const auto masks = suitMasks(hand);
+    const auto permutation = canonical(hand, trumpSuit);
+    quint32 key = 0;
+    for (uchar s = 0; s < 4; ++s)
+        key |= quint32(masks[s]) << (8 * permutation.m_map[s]);
+    return key;
+}
@@ -0,0 +1,112 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SUITPERMUTATION_H
+#define SUITPERMUTATION_H
+
+#include "card.h"
+#include "cardset.h"
+
+#include <QtGlobal>
+#include <QVector>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <vector>
+
+/**
+ * A relabelling of the four suits.
+ *
+ * The rules of klaverjas only distinguish between the suits by whether or not
+ * they are trumps; their colours matter for display only. Hands and game
+ * states that differ by a relabelling of the suits are therefore equivalent,
+ * so anything that caches or looks up results for them can do so on a
+ * canonical form instead.
+ *
+ * The canonical form is obtained by moving the trump suit, if known, to
+ * Clubs and ordering the other suits by decreasing signature into the
+ * remaining places. The signature of a suit is whatever describes its state
+ * completely, e.g. its rank mask for a single hand. Suits with equal
+ * signatures are interchangeable, so the resulting form does not depend on how
+ * such ties are broken.
+ *
+ * A move chosen in the canonical form is translated back by mapping it through
+ * the inverse() permutation.
+ */
+class SuitPermutation
+{
+public:
+    /// The identity permutation
+    SuitPermutation();
+
+    Card::Suit map(Card::Suit suit) const;
+    Card map(Card card) const;
+    CardSet map(const CardSet &cards) const;
+    std::vector<Card> map(const std::vector<Card> &cards) const;
+    SuitPermutation inverse() const;
+    bool isIdentity() const;
+    bool operator==(const SuitPermutation &other) const;
+
+    /// The permutation bringing a hand into canonical form before bidding,
+    /// when all four suits are interchangeable.
+    static SuitPermutation canonical(const CardSet &hand);
+    /// The permutation bringing a hand into canonical form for the given
+    /// trump suit.
+    static SuitPermutation canonical(const CardSet &hand, Card::Suit trumpSuit);
+    /// The four rank masks of the canonical form of a hand, packed from Clubs
+    /// in the low byte to Spades in the high byte.
+    static quint32 canonicalKey(const CardSet &hand, Card::Suit trumpSuit);
+
+    /**
+     * Order the suits by their signatures.
+     *
+     * @param signatures A comparable signature for each suit, indexed by
+     *      Card::suitIndex.
+     * @param trumpSuit The trump suit, which is kept apart from the others, or
+     *      a negative number if all suits may be permuted.
+     */
+    template<typename Signature>
+    static SuitPermutation fromSignatures(const std::array<Signature,4> &signatures, int trumpSuit = -1);
+
+private:
+    // Target suit index for each source suit index
+    std::array<uchar,4> m_map;
+};
+
+template<typename Signature>
+SuitPermutation SuitPermutation::fromSignatures(const std::array<Signature,4> &signatures, int trumpSuit)
+{
+    std::array<uchar,4> order;
+    std::iota(order.begin(), order.end(), 0);
+    auto first = order.begin();
+    if (trumpSuit >= 0) {
+        std::swap(order[0], order[trumpSuit]);
+        ++first;
+    }
+    std::stable_sort(first, order.end(), [&](uchar s1, uchar s2) {
+        return signatures[s2] < signatures[s1];
+    });
+    SuitPermutation permutation;
+    for (uchar target = 0; target < 4; ++target)
+        permutation.m_map[order[target]] = target;
+    return permutation;
+}
+
+#endif // SUITPERMUTATION_H
@@ -0,0 +1,55 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "aiseat.h"
+#include "table.h"
+#include "tablescheduler.h"
+#include "bidheuristic.h"
+#include "valuefunction.h"
+
+#include <ismcts/sosolver.h>
+
+#include <QtConcurrent>
+
+AiSeat::AiSeat(int iterations)
+    : m_iterations(iterations)
+{
+}
+
+void AiSeat::requestBid(Table &table, const DecisionRequest &request)
+{
+    table.submitBid(request.id, BidHeuristic::choose(table.hand(request.seat), request.bidOptions));
+}
+
+void AiSeat::requestMove(Table &table, const DecisionRequest &request)
+{
+    const std::shared_ptr<GameEngine> state = table.snapshot();
+    if (!state)
+        return;
+    state->setMergeEquivalentMoves(true);
+    state->setEarlyTermination(true);
+    state->setValueFunction(ValueFunction::shared(), ValueFunction::PlayoutTricks);
+    const auto target = table.shared_from_this();
+    const auto id = request.id;
+    const auto iterations = m_iterations;
+    QtConcurrent::run(table.scheduler()->searchPool(), [=]{
+        ISMCTS::SOSolver<Card> solver(iterations);
+        target->submitMove(id, solver(*state));
+    });
+}
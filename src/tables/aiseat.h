@@ -0,0 +1,44 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AISEAT_H
+#define AISEAT_H
+
+#include "seat.h"
+
+/**
+ * Seat played by the computer.
+ *
+ * Bids are chosen right away with the BidHeuristic, like the RandomPlayer's.
+ * Moves are searched for on a copy of the table's engine, in the scheduler's
+ * search pool, after which the move is submitted from that thread.
+ */
+class AiSeat : public Seat
+{
+public:
+    explicit AiSeat(int iterations = 2500);
+
+    void requestBid(Table &table, const DecisionRequest &request) override;
+    void requestMove(Table &table, const DecisionRequest &request) override;
+
+private:
+    int m_iterations;
+};
+
+#endif // AISEAT_H
@@ -0,0 +1,74 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SEAT_H
+#define SEAT_H
+
+#include "card.h"
+
+#include <QMetaType>
+#include <QtGlobal>
+#include <QVariantList>
+
+#include <vector>
+
+class Table;
+
+/// A bid or move a Table is waiting for
+struct DecisionRequest
+{
+    /// Identifies the request when the decision is submitted
+    quint64 id = 0;
+    int seat = -1;
+    bool isBid = false;
+    QVariantList bidOptions;
+    std::vector<Card> legalMoves;
+};
+
+Q_DECLARE_METATYPE(DecisionRequest)
+
+/**
+ * Participant at a Table.
+ *
+ * Unlike a Player, a Seat holds no state of its own and need not live in a
+ * particular thread. The table calls it when a decision is required and the
+ * seat answers through Table::submitBid or Table::submitMove, either right
+ * away or later from any thread.
+ */
+class Seat
+{
+public:
+    virtual ~Seat() = default;
+
+    virtual void requestBid(Table &table, const DecisionRequest &request) = 0;
+    virtual void requestMove(Table &table, const DecisionRequest &request) = 0;
+};
+
+/**
+ * Seat whose decisions are submitted to the table by its owner, e.g. in
+ * response to the table's BidRequested and MoveRequested events.
+ */
+class ExternalSeat : public Seat
+{
+public:
+    void requestBid(Table &, const DecisionRequest &) override {}
+    void requestMove(Table &, const DecisionRequest &) override {}
+};
+
+#endif // SEAT_H
@@ -0,0 +1,357 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "table.h"
+#include "tablescheduler.h"
+#include "players/baseplayer.h"
+
+#include <QLoggingCategory>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+Q_DECLARE_LOGGING_CATEGORY(klaverjasTable)
+
+Table::Table(int id, TableScheduler *scheduler, int numRounds, TrumpRule trumpRule, BidRule bidRule)
+    : m_id(id)
+    , m_scheduler(scheduler)
+    , m_seats(4)
+    , m_engine(nullptr)
+    , m_bidding(bidRule)
+    , m_random(std::random_device()())
+    , m_totals(2, 0)
+    , m_state(State::Idle)
+    , m_trumpRule(trumpRule)
+    , m_numRounds(numRounds)
+    , m_round(0)
+    , m_dealer(3)
+    , m_currentSeat(0)
+    , m_timeout(0)
+    , m_isAwaiting(false)
+    , m_isRequested(false)
+    , m_hasDecision(false)
+    , m_isRunning(false)
+    , m_resumeAgain(false)
+    , m_isPaused(false)
+{
+    m_deck.reserve(32);
+    for (uint i = 0; i < 32; ++i)
+        m_deck << Card::fromId(i);
+    for (int i = 0; i < 4; ++i)
+        m_hands << std::make_shared<BasePlayer>();
+}
+
+int Table::id() const
+{
+    return m_id;
+}
+
+TableScheduler *Table::scheduler() const
+{
+    return m_scheduler;
+}
+
+bool Table::setSeat(int seat, std::shared_ptr<Seat> participant)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_state != State::Idle || seat < 0 || seat > 3)
+        return false;
+    m_seats[seat] = participant;
+    return true;
+}
+
+bool Table::replaceSeat(int seat, std::shared_ptr<Seat> participant)
+{
+    QMutexLocker locker(&m_mutex);
+    if (seat < 0 || seat > 3 || !participant)
+        return false;
+    m_seats[seat] = participant;
+    if (m_isAwaiting && m_request.seat == seat) {
+        m_isRequested = false;
+        wake();
+    }
+    return true;
+}
+
+void Table::setListener(Listener listener)
+{
+    QMutexLocker locker(&m_mutex);
+    m_listener = listener;
+}
+
+void Table::setTimeout(int msecs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_timeout = msecs;
+}
+
+bool Table::start()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_state != State::Idle || m_seats.contains(nullptr))
+        return false;
+    m_state = State::Dealing;
+    wake();
+    return true;
+}
+
+void Table::setPaused(bool paused)
+{
+    QMutexLocker locker(&m_mutex);
+    if (paused == m_isPaused)
+        return;
+    m_isPaused = paused;
+    if (!paused && m_state != State::Idle)
+        wake();
+}
+
+bool Table::submitBid(quint64 requestId, const QVariant &bid)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_isAwaiting || m_request.id != requestId || !m_request.isBid || !m_request.bidOptions.contains(bid))
+        return false;
+    decide({bid, Card()});
+    return true;
+}
+
+bool Table::submitMove(quint64 requestId, Card card)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_isAwaiting || m_request.id != requestId || m_request.isBid)
+        return false;
+    const auto &moves = m_request.legalMoves;
+    if (std::find(moves.begin(), moves.end(), card) == moves.end())
+        return false;
+    decide({QVariant(), card});
+    return true;
+}
+
+CardSet Table::hand(int seat) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hands.value(seat) ? m_hands[seat]->hand() : CardSet();
+}
+
+std::unique_ptr<GameEngine> Table::snapshot() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_engine && m_state == State::Playing ? m_engine->clone() : nullptr;
+}
+
+QVector<uint> Table::totals() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_totals;
+}
+
+bool Table::isFinished() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_state == State::Finished;
+}
+
+/* Only one thread runs the state machine at a time; a call that arrives while
+ * it is running makes that thread go round once more instead. Events and new
+ * requests are collected under the lock and passed on after releasing it, so
+ * that listeners and seats may call back into the table.
+ */
+void Table::resume()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_isRunning) {
+            m_resumeAgain = true;
+            return;
+        }
+        m_isRunning = true;
+    }
+    forever {
+        QVector<TableEvent> events;
+        DecisionRequest request;
+        std::shared_ptr<Seat> seat;
+        Listener listener;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_isPaused) {
+                m_isRunning = false;
+                m_resumeAgain = false;
+                return;
+            }
+            while (step(events)) {}
+            if (m_isAwaiting && !m_isRequested) {
+                request = m_request;
+                seat = m_seats[request.seat];
+                m_isRequested = true;
+            }
+            if (events.isEmpty() && !seat && !m_resumeAgain) {
+                m_isRunning = false;
+                return;
+            }
+            m_resumeAgain = false;
+            listener = m_listener;
+        }
+        if (listener) {
+            for (const auto &e : qAsConst(events))
+                listener(e);
+        }
+        if (seat) {
+            if (request.isBid)
+                seat->requestBid(*this, request);
+            else
+                seat->requestMove(*this, request);
+        }
+    }
+}
+
+void Table::checkTimeout()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_isAwaiting || m_timeout <= 0 || !m_requestTimer.hasExpired(m_timeout))
+        return;
+    qCDebug(klaverjasTable) << "Table" << m_id << "seat" << m_request.seat << "timed out";
+    if (m_request.isBid) {
+        const auto &options = m_request.bidOptions;
+        decide({options.contains(QVariant()) ? QVariant() : options.first(), Card()});
+    } else {
+        decide({QVariant(), m_request.legalMoves.front()});
+    }
+}
+
+// Perform a single transition, returning false if the table has to wait
+bool Table::step(QVector<TableEvent> &events)
+{
+    if (m_hasDecision) {
+        m_hasDecision = false;
+        applyDecision(events);
+        return true;
+    }
+    if (m_isAwaiting)
+        return false;
+
+    switch (m_state) {
+    case State::Dealing:
+        deal(events);
+        return true;
+    case State::Bidding:
+        m_request.bidOptions = m_bidding.next(m_random);
+        if (m_request.bidOptions.isEmpty())
+            setContract(m_bidding.drawnSuit(), events);
+        else
+            await(true, events);
+        return true;
+    case State::Playing:
+        if (m_engine->isFinished()) {
+            finishRound(events);
+        } else {
+            m_request.legalMoves = m_engine->validMoves();
+            await(false, events);
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+void Table::deal(QVector<TableEvent> &events)
+{
+    std::shuffle(m_deck.begin(), m_deck.end(), m_random);
+    for (int i = 0; i < 4; ++i)
+        m_hands[i]->setHand(m_deck.mid(i * 8, 8));
+    m_dealer = (m_dealer + 1) % 4;
+    m_currentSeat = (m_dealer + 1) % 4;
+    m_bidding.start(m_round == 0);
+    m_state = State::Bidding;
+    events << TableEvent{TableEvent::Type::NewRound, m_dealer, Card(), QVariant(), {}};
+}
+
+void Table::await(bool isBid, QVector<TableEvent> &events)
+{
+    m_request.id += 1;
+    m_request.seat = m_currentSeat;
+    m_request.isBid = isBid;
+    m_isAwaiting = true;
+    m_isRequested = false;
+    m_requestTimer.start();
+    const auto type = isBid ? TableEvent::Type::BidRequested : TableEvent::Type::MoveRequested;
+    events << TableEvent{type, m_currentSeat, Card(), QVariant(), {}};
+}
+
+void Table::decide(const Decision &decision)
+{
+    m_decision = decision;
+    m_hasDecision = true;
+    m_isAwaiting = false;
+    wake();
+}
+
+void Table::applyDecision(QVector<TableEvent> &events)
+{
+    const int seat = m_request.seat;
+    if (m_request.isBid) {
+        events << TableEvent{TableEvent::Type::BidSelected, seat, Card(), m_decision.bid, {}};
+        if (m_decision.bid.isNull())
+            m_currentSeat = (seat + 1) % 4;
+        else
+            setContract(m_decision.bid.value<Card::Suit>(), events);
+    } else {
+        events << TableEvent{TableEvent::Type::CardPlayed, seat, m_decision.move, QVariant(), {}};
+        m_engine->doMove(m_decision.move);
+        m_currentSeat = m_engine->currentPlayer();
+        if (m_engine->currentTrick().cards().isEmpty())
+            events << TableEvent{TableEvent::Type::NewTrick, m_currentSeat, Card(), QVariant(), {}};
+    }
+}
+
+void Table::setContract(Card::Suit suit, QVector<TableEvent> &events)
+{
+    const auto eldest = GameEngine::Position((m_dealer + 1) % 4);
+    const auto contractor = GameEngine::Position(m_currentSeat);
+    if (m_engine)
+        m_engine->reset(eldest, contractor, suit);
+    else
+        m_engine = GameEngine::create(m_hands, eldest, contractor, m_trumpRule, suit);
+    m_currentSeat = int(eldest);
+    m_state = State::Playing;
+    events << TableEvent{TableEvent::Type::NewContract, int(contractor), Card(), QVariant::fromValue(suit), {}};
+    events << TableEvent{TableEvent::Type::NewTrick, m_currentSeat, Card(), QVariant(), {}};
+}
+
+void Table::finishRound(QVector<TableEvent> &events)
+{
+    const auto scores = m_engine->scores();
+    for (int i : {0, 1})
+        m_totals[i] += scores[i].sum();
+    events << TableEvent{TableEvent::Type::RoundFinished, -1, Card(), QVariant(), scores};
+    if (++m_round == m_numRounds) {
+        m_state = State::Finished;
+        events << TableEvent{TableEvent::Type::GameFinished, -1, Card(), QVariant(), {}};
+        qCDebug(klaverjasTable) << "Table" << m_id << "finished:" << m_totals;
+    } else {
+        m_state = State::Dealing;
+    }
+}
+
+// Called with the lock held
+void Table::wake()
+{
+    if (m_isRunning)
+        m_resumeAgain = true;
+    else
+        m_scheduler->schedule(shared_from_this());
+}
@@ -0,0 +1,175 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TABLE_H
+#define TABLE_H
+
+#include "seat.h"
+#include "bidding.h"
+#include "card.h"
+#include "cardset.h"
+#include "gameengine.h"
+#include "rules.h"
+#include "scores.h"
+
+#include <QElapsedTimer>
+#include <QMetaType>
+#include <QMutex>
+#include <QVariant>
+#include <QVector>
+
+#include <functional>
+#include <memory>
+#include <random>
+
+class TableScheduler;
+
+/// Notification of a change in the state of a Table
+struct TableEvent
+{
+    enum class Type : uchar {
+        NewRound,
+        BidRequested,
+        MoveRequested,
+        BidSelected,
+        NewContract,
+        NewTrick,
+        CardPlayed,
+        RoundFinished,
+        GameFinished
+    };
+
+    TableEvent(Type type = Type::NewRound, int seat = -1, Card card = Card(), QVariant bid = QVariant(), QVector<RoundScore> scores = {})
+        : type(type), seat(seat), card(card), bid(bid), scores(scores) {}
+
+    Type type;
+    /// The player concerned, or the leader of a new trick
+    int seat;
+    Card card;
+    QVariant bid;
+    /// The round scores of both teams for RoundFinished events
+    QVector<RoundScore> scores;
+};
+
+Q_DECLARE_METATYPE(TableEvent)
+
+/**
+ * A game of klaverjas without interface, for hosting many games at once.
+ *
+ * A Table plays the rounds of a game on top of a GameEngine. It is written as
+ * a resumable state machine: resume() advances the game until it has to wait
+ * for a decision from one of its seats, after which it returns. Submitting the
+ * decision schedules the table on its TableScheduler, whose worker threads
+ * resume it again. A waiting table therefore holds no thread, so a few workers
+ * can serve any number of tables.
+ *
+ * All public methods are thread-safe. Events are passed to the listener from
+ * the thread that resumed the table, in order, without holding its lock.
+ */
+class Table : public std::enable_shared_from_this<Table>
+{
+public:
+    using SeatList = QVector<std::shared_ptr<Seat>>;
+    using Listener = std::function<void(const TableEvent &event)>;
+
+    Table(int id, TableScheduler *scheduler, int numRounds = 16,
+          TrumpRule trumpRule = TrumpRule::Amsterdams, BidRule bidRule = BidRule::Random);
+
+    int id() const;
+    TableScheduler *scheduler() const;
+    /// Seat a participant; only possible before the game has started.
+    bool setSeat(int seat, std::shared_ptr<Seat> participant);
+    /// Seat a participant in place of another at any time, e.g. when a
+    /// client leaves; a decision the seat owes is requested again from the
+    /// new participant.
+    bool replaceSeat(int seat, std::shared_ptr<Seat> participant);
+    void setListener(Listener listener);
+    /// Time allowed for each decision in milliseconds, or 0 to wait
+    /// indefinitely. Late decisions are replaced by a pass or the first legal
+    /// move.
+    void setTimeout(int msecs);
+    /// Start the game if all seats are taken.
+    bool start();
+    /// Stop advancing the game until unpaused, e.g. while a listener catches
+    /// up with the events.
+    void setPaused(bool paused);
+
+    bool submitBid(quint64 requestId, const QVariant &bid);
+    bool submitMove(quint64 requestId, Card card);
+
+    CardSet hand(int seat) const;
+    /// A copy of the current engine state, if a round is being played
+    std::unique_ptr<GameEngine> snapshot() const;
+    /// The total score of each team
+    QVector<uint> totals() const;
+    bool isFinished() const;
+
+    /// Advance the game until a decision is needed; called by the scheduler.
+    void resume();
+    /// Replace the decision being waited for if it is overdue.
+    void checkTimeout();
+
+private:
+    enum class State { Idle, Dealing, Bidding, Playing, Finished };
+    struct Decision
+    {
+        QVariant bid;
+        Card move;
+    };
+
+    bool step(QVector<TableEvent> &events);
+    void deal(QVector<TableEvent> &events);
+    void await(bool isBid, QVector<TableEvent> &events);
+    void applyDecision(QVector<TableEvent> &events);
+    void setContract(Card::Suit suit, QVector<TableEvent> &events);
+    void finishRound(QVector<TableEvent> &events);
+    void decide(const Decision &decision);
+    void wake();
+
+    mutable QMutex m_mutex;
+    const int m_id;
+    TableScheduler *const m_scheduler;
+    SeatList m_seats;
+    GameEngine::PlayerList m_hands;
+    std::unique_ptr<GameEngine> m_engine;
+    Listener m_listener;
+    Bidding m_bidding;
+    // Tables run on several threads at once, so each draws its own deals
+    std::mt19937 m_random;
+    QVector<Card> m_deck;
+    QVector<uint> m_totals;
+    DecisionRequest m_request;
+    Decision m_decision;
+    QElapsedTimer m_requestTimer;
+    State m_state;
+    TrumpRule m_trumpRule;
+    int m_numRounds;
+    int m_round;
+    int m_dealer;
+    int m_currentSeat;
+    int m_timeout;
+    bool m_isAwaiting;
+    bool m_isRequested;
+    bool m_hasDecision;
+    bool m_isRunning;
+    bool m_resumeAgain;
+    bool m_isPaused;
+};
+
+#endif // TABLE_H
@@ -0,0 +1,108 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "tablescheduler.h"
+
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+
+namespace {
+
+class ResumeTask : public QRunnable
+{
+public:
+    explicit ResumeTask(std::shared_ptr<Table> table) : m_table(table) {}
+    void run() override { m_table->resume(); }
+
+private:
+    std::shared_ptr<Table> m_table;
+};
+
+} // namespace
+
+TableScheduler::TableScheduler(int searchThreads, QObject *parent)
+    : QObject(parent)
+    , m_nextId(1)
+{
+    m_searchPool.setMaxThreadCount(searchThreads > 0 ? searchThreads : QThread::idealThreadCount());
+    m_timeoutTimer.setInterval(100);
+    connect(&m_timeoutTimer, &QTimer::timeout, this, &TableScheduler::checkTimeouts);
+    m_timeoutTimer.start();
+}
+
+TableScheduler::~TableScheduler()
+{
+    m_timeoutTimer.stop();
+    waitForDone();
+}
+
+std::shared_ptr<Table> TableScheduler::createTable(int numRounds, TrumpRule trumpRule, BidRule bidRule)
+{
+    QMutexLocker locker(&m_mutex);
+    const int id = m_nextId++;
+    auto table = std::make_shared<Table>(id, this, numRounds, trumpRule, bidRule);
+    m_tables.insert(id, table);
+    return table;
+}
+
+std::shared_ptr<Table> TableScheduler::table(int id) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_tables.value(id);
+}
+
+void TableScheduler::removeTable(int id)
+{
+    QMutexLocker locker(&m_mutex);
+    m_tables.remove(id);
+}
+
+int TableScheduler::tableCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_tables.size();
+}
+
+void TableScheduler::schedule(std::shared_ptr<Table> table)
+{
+    m_tablePool.start(new ResumeTask(table));
+}
+
+QThreadPool *TableScheduler::searchPool()
+{
+    return &m_searchPool;
+}
+
+void TableScheduler::waitForDone()
+{
+    m_searchPool.waitForDone();
+    m_tablePool.waitForDone();
+}
+
+void TableScheduler::checkTimeouts()
+{
+    QList<std::shared_ptr<Table>> tables;
+    {
+        QMutexLocker locker(&m_mutex);
+        tables = m_tables.values();
+    }
+    for (const auto &t : tables)
+        t->checkTimeout();
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TABLESCHEDULER_H
+#define TABLESCHEDULER_H
+
+#include "table.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <memory>
+
+/**
+ * Host for many concurrent tables.
+ *
+ * The scheduler owns two thread pools: one whose workers resume tables that
+ * have received a decision, and one on which AiSeat runs its searches. Both
+ * queue their work in order of arrival, so the searches of all tables share
+ * the cores fairly. Decision timeouts are checked by a timer in the thread
+ * the scheduler lives in.
+ */
+class TableScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param searchThreads The maximum number of concurrent AI searches, or 0
+     *      to use the number of cores.
+     */
+    explicit TableScheduler(int searchThreads = 0, QObject *parent = nullptr);
+    ~TableScheduler() override;
+
+    std::shared_ptr<Table> createTable(int numRounds = 16, TrumpRule trumpRule = TrumpRule::Amsterdams,
+                                       BidRule bidRule = BidRule::Random);
+    std::shared_ptr<Table> table(int id) const;
+    void removeTable(int id);
+    int tableCount() const;
+
+    /// Resume the table on one of the worker threads
+    void schedule(std::shared_ptr<Table> table);
+    QThreadPool *searchPool();
+    /// Wait until all scheduled work has finished
+    void waitForDone();
+
+private slots:
+    void checkTimeouts();
+
+private:
+    mutable QMutex m_mutex;
+    QHash<int,std::shared_ptr<Table>> m_tables;
+    QThreadPool m_tablePool;
+    QThreadPool m_searchPool;
+    QTimer m_timeoutTimer;
+    int m_nextId;
+};
+
+#endif // TABLESCHEDULER_H
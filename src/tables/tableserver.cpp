@@ -0,0 +1,355 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "tableserver.h"
+#include "aiseat.h"
+#include "notation.h"
+
+#include <QLocalSocket>
+#include <QLoggingCategory>
+
+#include <memory>
+
+Q_DECLARE_LOGGING_CATEGORY(klaverjasTable)
+
+namespace {
+
+const qint64 HighWater = 1 << 16;
+const qint64 LowWater = 1 << 12;
+
+/// Seat played by a client of the server
+class RemoteSeat : public Seat
+{
+public:
+    explicit RemoteSeat(TableServer *server) : m_server(server) {}
+
+    void requestBid(Table &table, const DecisionRequest &request) override { post(table, request); }
+    void requestMove(Table &table, const DecisionRequest &request) override { post(table, request); }
+
+private:
+    void post(Table &table, const DecisionRequest &request)
+    {
+        emit m_server->decisionRequested(table.id(), request, Notation::cards(table.hand(request.seat)));
+    }
+
+    TableServer *m_server;
+};
+
+QString bidName(const QVariant &bid)
+{
+    return bid.isNull() ? QStringLiteral("pass") : Notation::suit(bid.value<Card::Suit>());
+}
+
+} // namespace
+
+TableServer::TableServer(int searchThreads, QObject *parent)
+    : QObject(parent)
+    , m_scheduler(searchThreads)
+{
+    qRegisterMetaType<TableEvent>("TableEvent");
+    qRegisterMetaType<DecisionRequest>("DecisionRequest");
+    connect(this, &TableServer::tableEvent, this, &TableServer::sendEvent, Qt::QueuedConnection);
+    connect(this, &TableServer::decisionRequested, this, &TableServer::sendRequest, Qt::QueuedConnection);
+    connect(&m_server, &QLocalServer::newConnection, this, &TableServer::acceptConnection);
+}
+
+// Stop all tables before their seats and listeners outlive the server
+TableServer::~TableServer()
+{
+    for (const auto &info : qAsConst(m_tables)) {
+        info.table->setPaused(true);
+        info.table->setListener(nullptr);
+    }
+    m_scheduler.waitForDone();
+}
+
+bool TableServer::listen(const QString &name)
+{
+    QLocalServer::removeServer(name);
+    return m_server.listen(name);
+}
+
+QString TableServer::errorString() const
+{
+    return m_server.errorString();
+}
+
+void TableServer::acceptConnection()
+{
+    while (m_server.hasPendingConnections()) {
+        auto client = m_server.nextPendingConnection();
+        connect(client, &QLocalSocket::readyRead, this, &TableServer::readCommands);
+        connect(client, &QLocalSocket::bytesWritten, this, &TableServer::resumeTables);
+        connect(client, &QLocalSocket::disconnected, this, &TableServer::removeClient);
+    }
+}
+
+void TableServer::readCommands()
+{
+    auto client = qobject_cast<QLocalSocket*>(sender());
+    while (client && client->canReadLine()) {
+        const auto line = QString::fromUtf8(client->readLine()).trimmed();
+        if (!line.isEmpty())
+            send(client, execute(client, line.split(' ', QString::SkipEmptyParts)));
+    }
+}
+
+void TableServer::removeClient()
+{
+    auto client = qobject_cast<QLocalSocket*>(sender());
+    if (!client)
+        return;
+    for (auto t = m_tables.begin(); t != m_tables.end();) {
+        if (t->owner == client) {
+            t->table->setPaused(true);
+            t->table->setListener(nullptr);
+            m_scheduler.removeTable(t.key());
+            t = m_tables.erase(t);
+        } else {
+            // The computer takes over the client's seats, including any
+            // decision they still owe, so that the game can go on
+            for (int seat = 0; seat < t->clients.size(); ++seat) {
+                if (t->clients[seat] == client) {
+                    t->clients[seat] = nullptr;
+                    t->table->replaceSeat(seat, std::make_shared<AiSeat>());
+                }
+            }
+            ++t;
+        }
+    }
+    // Tables paused for the client would otherwise wait for its socket
+    if (m_throttled.remove(client))
+        resumeUnthrottled();
+    client->deleteLater();
+}
+
+QString TableServer::execute(QLocalSocket *client, const QStringList &command)
+{
+    static const QStringList TableCommands {"seat", "timeout", "start", "bid", "move", "close"};
+    const auto name = command.value(0);
+    bool ok = true;
+    if (name == "create") {
+        const int rounds = command.size() > 1 ? command.at(1).toInt(&ok) : 16;
+        if (!ok || rounds < 1)
+            return QStringLiteral("error invalid number of rounds");
+        TableInfo info;
+        info.table = m_scheduler.createTable(rounds);
+        info.owner = client;
+        info.clients.fill(nullptr, 4);
+        info.requests.fill(0, 4);
+        const int id = info.table->id();
+        info.table->setListener([this, id](const TableEvent &event) {
+            emit tableEvent(id, event);
+        });
+        m_tables.insert(id, info);
+        qCDebug(klaverjasTable) << "Created table" << id;
+        return QString("table %1").arg(id);
+    }
+    if (!TableCommands.contains(name))
+        return QStringLiteral("error unknown command");
+
+    const int id = command.value(1).toInt(&ok);
+    if (!ok || !m_tables.contains(id))
+        return QStringLiteral("error unknown table");
+    auto &info = m_tables[id];
+    if (name == "seat")
+        return seat(client, info, command);
+    if (name == "bid" || name == "move")
+        return decide(client, info, command);
+    if (client != info.owner)
+        return QStringLiteral("error not the owner of this table");
+    if (name == "timeout") {
+        const int msecs = command.value(2).toInt(&ok);
+        if (!ok || msecs < 0)
+            return QStringLiteral("error invalid timeout");
+        info.table->setTimeout(msecs);
+    } else if (name == "start") {
+        if (!info.table->start())
+            return QStringLiteral("error table is not ready to start");
+    } else if (name == "close") {
+        info.table->setPaused(true);
+        info.table->setListener(nullptr);
+        m_scheduler.removeTable(id);
+        m_tables.remove(id);
+    }
+    return QStringLiteral("ok");
+}
+
+QString TableServer::seat(QLocalSocket *client, TableInfo &info, const QStringList &command)
+{
+    bool ok;
+    const int seat = command.value(2).toInt(&ok);
+    if (!ok || seat < 0 || seat > 3)
+        return QStringLiteral("error invalid seat");
+    if (client != info.owner && command.value(3) != "client")
+        return QStringLiteral("error not the owner of this table");
+
+    std::shared_ptr<Seat> participant;
+    if (command.value(3) == "ai") {
+        const int iterations = command.size() > 4 ? command.at(4).toInt(&ok) : 2500;
+        if (!ok || iterations < 1)
+            return QStringLiteral("error invalid number of iterations");
+        participant = std::make_shared<AiSeat>(iterations);
+    } else if (command.value(3) == "client") {
+        participant = std::make_shared<RemoteSeat>(this);
+    } else {
+        return QStringLiteral("error unknown seat type");
+    }
+    if (!info.table->setSeat(seat, participant))
+        return QStringLiteral("error table has already started");
+    info.clients[seat] = command.value(3) == "client" ? client : nullptr;
+    return QStringLiteral("ok");
+}
+
+QString TableServer::decide(QLocalSocket *client, TableInfo &info, const QStringList &command)
+{
+    bool ok;
+    const int seat = command.value(2).toInt(&ok);
+    if (!ok || info.clients.value(seat) != client)
+        return QStringLiteral("error not seated there");
+
+    const auto choice = command.value(3);
+    if (command.first() == "bid") {
+        QVariant bid;
+        Card::Suit suit;
+        if (choice != "pass") {
+            if (!Notation::parseSuit(choice, &suit))
+                return QStringLiteral("error invalid suit");
+            bid = QVariant::fromValue(suit);
+        }
+        ok = info.table->submitBid(info.requests[seat], bid);
+    } else {
+        Card card;
+        if (!Notation::parseCard(choice, &card))
+            return QStringLiteral("error invalid card");
+        ok = info.table->submitMove(info.requests[seat], card);
+    }
+    return ok ? QStringLiteral("ok") : QStringLiteral("error decision not accepted");
+}
+
+void TableServer::sendEvent(int tableId, const TableEvent &event)
+{
+    const auto info = m_tables.value(tableId);
+    if (!info.table)
+        return;
+
+    QString line = QString("event %1 ").arg(tableId);
+    switch (event.type) {
+    case TableEvent::Type::NewRound:
+        line += QString("newround %1").arg(event.seat);
+        break;
+    case TableEvent::Type::BidRequested:
+    case TableEvent::Type::MoveRequested:
+        line += QString("turn %1").arg(event.seat);
+        break;
+    case TableEvent::Type::BidSelected:
+        line += QString("bid %1 %2").arg(event.seat).arg(bidName(event.bid));
+        break;
+    case TableEvent::Type::NewContract:
+        line += QString("contract %1 %2").arg(event.seat).arg(bidName(event.bid));
+        break;
+    case TableEvent::Type::NewTrick:
+        line += QString("newtrick %1").arg(event.seat);
+        break;
+    case TableEvent::Type::CardPlayed:
+        line += QString("card %1 %2").arg(event.seat).arg(Notation::card(event.card));
+        break;
+    case TableEvent::Type::RoundFinished:
+        line += QStringLiteral("scores");
+        for (const auto &s : event.scores)
+            line += QString(" %1 %2").arg(s.points).arg(s.bonus);
+        break;
+    case TableEvent::Type::GameFinished: {
+        const auto totals = info.table->totals();
+        line += QString("finished %1 %2").arg(totals[0]).arg(totals[1]);
+        break;
+    }
+    }
+    for (const auto client : followers(info))
+        send(client, line);
+}
+
+void TableServer::sendRequest(int tableId, const DecisionRequest &request, const QString &hand)
+{
+    if (!m_tables.contains(tableId))
+        return;
+    auto &info = m_tables[tableId];
+    info.requests[request.seat] = request.id;
+    const auto client = info.clients.at(request.seat);
+    if (!client)
+        return;
+
+    QStringList options;
+    if (request.isBid) {
+        for (const auto &bid : request.bidOptions)
+            options << bidName(bid);
+    }
+    send(client, QString("hand %1 %2 %3").arg(tableId).arg(request.seat).arg(hand));
+    send(client, QString("request %1 %2 %3 %4").arg(tableId).arg(request.seat)
+        .arg(request.isBid ? "bid" : "move")
+        .arg(request.isBid ? options.join(' ') : Notation::cards(request.legalMoves)));
+}
+
+QSet<QLocalSocket*> TableServer::followers(const TableInfo &info) const
+{
+    QSet<QLocalSocket*> clients;
+    if (info.owner)
+        clients << info.owner;
+    for (const auto c : info.clients) {
+        if (c)
+            clients << c;
+    }
+    return clients;
+}
+
+void TableServer::send(QLocalSocket *client, const QString &line)
+{
+    client->write(line.toUtf8() + '\n');
+    throttle(client);
+}
+
+// Pause the tables a client follows while its output backs up
+void TableServer::throttle(QLocalSocket *client)
+{
+    if (client->bytesToWrite() < HighWater || m_throttled.contains(client))
+        return;
+    m_throttled << client;
+    for (const auto &info : qAsConst(m_tables)) {
+        if (followers(info).contains(client))
+            info.table->setPaused(true);
+    }
+}
+
+void TableServer::resumeTables()
+{
+    auto client = qobject_cast<QLocalSocket*>(sender());
+    if (!client || !m_throttled.contains(client) || client->bytesToWrite() > LowWater)
+        return;
+    m_throttled.remove(client);
+    resumeUnthrottled();
+}
+
+// Resume the tables none of whose followers is throttled
+void TableServer::resumeUnthrottled()
+{
+    for (const auto &info : qAsConst(m_tables)) {
+        if (!followers(info).intersects(m_throttled))
+            info.table->setPaused(false);
+    }
+}
@@ -0,0 +1,111 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TABLESERVER_H
+#define TABLESERVER_H
+
+#include "table.h"
+#include "tablescheduler.h"
+
+#include <QHash>
+#include <QLocalServer>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+class QLocalSocket;
+
+/**
+ * Headless server hosting many tables over a local (Unix domain) socket.
+ *
+ * Clients talk to the server in lines of text, using the card notation of
+ * Notation. Each command is answered by "ok", "table <id>" or
+ * "error <reason>":
+ *
+ *      create [<rounds>]               Create a table
+ *      seat <id> <seat> ai [<iterations>]
+ *      seat <id> <seat> client         Seat the AI or this connection
+ *      timeout <id> <msecs>            Time allowed per decision
+ *      start <id>                      Start once all four seats are taken
+ *      bid <id> <seat> <suit>|pass     Answer a bid request
+ *      move <id> <seat> <card>         Answer a move request
+ *      close <id>                      Remove the table
+ *
+ * The creator of a table and the clients seated at it receive its events as
+ * "event <id> <type> <arguments>", where the types are newround, turn, bid,
+ * contract, newtrick, card, scores and finished. A client seat is asked for
+ * its decisions with "hand <id> <seat> <cards>" followed by
+ * "request <id> <seat> bid <options>" or "request <id> <seat> move <cards>".
+ *
+ * AI searches run on a pool of bounded size. When a client does not read its
+ * events fast enough, the tables it follows are paused until it catches up.
+ * When a client disconnects, the tables it created are closed and the AI
+ * takes over its seats at the other tables.
+ */
+class TableServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TableServer(int searchThreads = 0, QObject *parent = nullptr);
+    ~TableServer() override;
+
+    bool listen(const QString &name);
+    QString errorString() const;
+
+signals:
+    // Emitted from the tables' threads, handled in the server's thread
+    void tableEvent(int tableId, const TableEvent &event);
+    void decisionRequested(int tableId, const DecisionRequest &request, const QString &hand);
+
+private slots:
+    void acceptConnection();
+    void readCommands();
+    void removeClient();
+    void resumeTables();
+    void sendEvent(int tableId, const TableEvent &event);
+    void sendRequest(int tableId, const DecisionRequest &request, const QString &hand);
+
+private:
+    struct TableInfo
+    {
+        std::shared_ptr<Table> table;
+        QLocalSocket *owner = nullptr;
+        /// The connection playing each seat, if any
+        QVector<QLocalSocket*> clients;
+        /// The decision each client seat is asked for
+        QVector<quint64> requests;
+    };
+
+    QString execute(QLocalSocket *client, const QStringList &command);
+    QString seat(QLocalSocket *client, TableInfo &info, const QStringList &command);
+    QString decide(QLocalSocket *client, TableInfo &info, const QStringList &command);
+    QSet<QLocalSocket*> followers(const TableInfo &info) const;
+    void send(QLocalSocket *client, const QString &line);
+    void throttle(QLocalSocket *client);
+    void resumeUnthrottled();
+
+    QLocalServer m_server;
+    TableScheduler m_scheduler;
+    QHash<int,TableInfo> m_tables;
+    QSet<QLocalSocket*> m_throttled;
+};
+
+#endif // TABLESERVER_H
@@ -21,12 +21,11 @@
 #include "players/player.h"
 
 #include <QDebug>
-#include <QVariantList>
 
 Team::Team(QString name, QObject* parent)
     : QObject(parent)
     , m_name(name)
-    , m_total(0)
+    , m_scores(new ScoreModel(this))
 {
 }
 
@@ -60,30 +59,25 @@ void Team::removePlayer(Player* p)
     p->setTeam(nullptr);
 }
 
-QVariantList Team::scores()
+ScoreModel *Team::scores() const
 {
-    QVariantList newList;
-    foreach(const auto item, m_score)
-        newList << QVariant::fromValue(item);
-    return newList;
+    return m_scores;
 }
 
 uint Team::totalScore() const
 {
-    return m_total;
+    return m_scores->total();
 }
 
 void Team::addPoints(RoundScore score)
 {
-    m_score << score;
-    m_total += score.sum();
+    m_scores->append(score);
     emit scoreChanged(score);
 }
 
 void Team::resetScore()
 {
-    m_score.clear();
-    m_total = 0;
+    m_scores->clear();
     emit scoreChanged(RoundScore());
 }
 
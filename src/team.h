@@ -21,6 +21,7 @@
 #define TEAM_H
 
 #include "scores.h"
+#include "scoremodel.h"
 
 #include <QObject>
 #include <QString>
@@ -31,12 +32,12 @@ class Player;
 class Team : public QObject
 {
     Q_OBJECT
-    Q_PROPERTY(QVariantList scores READ scores NOTIFY scoreChanged)
+    Q_PROPERTY(ScoreModel *scores READ scores CONSTANT)
     Q_PROPERTY(uint totalScore READ totalScore NOTIFY scoreChanged)
     Q_PROPERTY(QString name READ name WRITE setName NOTIFY nameChanged)
 
 public:
-    Team(QObject* parent = 0) : QObject(parent) {};
+    Team(QObject* parent = 0) : Team(QString(), parent) {};
     Team(QString name, QObject* parent = 0);
 
     const QString& name() const;
@@ -46,7 +47,7 @@ public:
     void addPlayer(Player* p);
     void removePlayer(Player* p);
 
-    QVariantList scores();
+    ScoreModel *scores() const;
     uint totalScore() const;
 
 public slots:
@@ -60,8 +61,7 @@ signals:
 private:
     QString m_name;
     QVector<Player*> m_players;
-    QVector<RoundScore> m_score;
-    uint m_total;
+    ScoreModel *m_scores;
 
     friend QDebug operator<<(QDebug dbg, const Team* team);
 };
@@ -0,0 +1,149 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "trace.h"
+
+#ifdef KLAVERJAS_TRACING
+
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTextStream>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct Event
+{
+    const char *category;
+    const char *name;
+    qint64 start;
+    qint64 duration;
+};
+
+/* Events of a single thread. Only the owning thread appends, publishing each
+ * event by incrementing the size, so the events below the size can be read
+ * from any thread. Events past the capacity are dropped.
+ */
+struct Buffer
+{
+    static const int Capacity = 1 << 16;
+
+    explicit Buffer(int threadId)
+        : threadId(threadId)
+        , size(0)
+    {
+    }
+
+    const int threadId;
+    std::atomic<int> size;
+    std::array<Event,Capacity> events;
+};
+
+// Owns the buffers, so that they outlive their threads and can be saved at exit
+struct Recorder
+{
+    Recorder()
+        : start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~Recorder()
+    {
+        const auto fileName = qgetenv("KLAVERJAS_TRACE_FILE");
+        if (!fileName.isEmpty())
+            Trace::save(QString::fromLocal8Bit(fileName));
+    }
+
+    const std::chrono::steady_clock::time_point start;
+    QMutex mutex;
+    std::vector<std::unique_ptr<Buffer>> buffers;
+};
+
+Recorder &recorder()
+{
+    static Recorder instance;
+    return instance;
+}
+
+Buffer &threadBuffer()
+{
+    static thread_local Buffer *buffer = nullptr;
+    if (!buffer) {
+        auto &r = recorder();
+        QMutexLocker lock(&r.mutex);
+        r.buffers.emplace_back(new Buffer(int(r.buffers.size()) + 1));
+        buffer = r.buffers.back().get();
+    }
+    return *buffer;
+}
+
+} // namespace
+
+namespace Trace {
+
+qint64 now()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now() - recorder().start).count();
+}
+
+void record(const char *category, const char *name, qint64 start, qint64 duration)
+{
+    auto &buffer = threadBuffer();
+    const int size = buffer.size.load(std::memory_order_relaxed);
+    if (size == Buffer::Capacity)
+        return;
+    buffer.events[size] = {category, name, start, duration};
+    buffer.size.store(size + 1, std::memory_order_release);
+}
+
+bool save(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto &r = recorder();
+    QMutexLocker lock(&r.mutex);
+    for (const auto &buffer : r.buffers) {
+        const int size = buffer->size.load(std::memory_order_acquire);
+        for (int i = 0; i < size; ++i) {
+            const auto &event = buffer->events[i];
+            out << (first ? "\n" : ",\n")
+                << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"cat\":\"" << event.category << "\",\"name\":\"" << event.name
+                << "\",\"ts\":" << event.start << ",\"dur\":" << event.duration << '}';
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    return out.status() == QTextStream::Ok;
+}
+
+} // namespace Trace
+
+#endif // KLAVERJAS_TRACING
@@ -0,0 +1,87 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/**
+ * Scoped trace markers for profiling.
+ *
+ * KLAVERJAS_TRACE(category, name) records the time from its location until
+ * the end of the enclosing scope. Both arguments must be string literals.
+ * Events are recorded in a buffer per thread without locking, and written as
+ * Chrome trace event JSON, which Perfetto and chrome://tracing can show as a
+ * timeline, to the file named by the environment variable
+ * KLAVERJAS_TRACE_FILE when the program exits.
+ *
+ * The markers only exist if the build is configured with KLAVERJAS_TRACING;
+ * otherwise they compile to nothing.
+ */
+
+#ifdef KLAVERJAS_TRACING
+
+#include <QString>
+#include <QtGlobal>
+
+namespace Trace {
+
+/// Microseconds since tracing started
+qint64 now();
+void record(const char *category, const char *name, qint64 start, qint64 duration);
+/// Write the events recorded so far; returns false if the file cannot be written
+bool save(const QString &fileName);
+
+class Scope
+{
+public:
+    Scope(const char *category, const char *name)
+        : m_category(category)
+        , m_name(name)
+        , m_start(now())
+    {
+    }
+
+    ~Scope()
+    {
+        record(m_category, m_name, m_start, now() - m_start);
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    const char *m_category;
+    const char *m_name;
+    qint64 m_start;
+};
+
+} // namespace Trace
+
+#define KLAVERJAS_TRACE_CONCAT_(a, b) a##b
+#define KLAVERJAS_TRACE_CONCAT(a, b) KLAVERJAS_TRACE_CONCAT_(a, b)
+#define KLAVERJAS_TRACE(category, name) \
+    Trace::Scope KLAVERJAS_TRACE_CONCAT(traceScope, __LINE__)(category, name)
+
+#else
+
+#define KLAVERJAS_TRACE(category, name) do {} while (false)
+
+#endif // KLAVERJAS_TRACING
+
+#endif // TRACE_H
@@ -0,0 +1,120 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Fit a ValueFunction to rounds of self-play. Each round is dealt at random
+ * and played by the search with the given number of iterations per move, or
+ * by random moves; the states between tricks are recorded along with the final
+ * scores, and the weights are fitted to these records.
+ */
+
+#include "gameengine.h"
+#include "valuefunction.h"
+#include "players/baseplayer.h"
+
+#include <ismcts/sosolver.h>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QLoggingCategory>
+#include <QTextStream>
+#include <QTime>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+std::unique_ptr<GameEngine> randomDeal()
+{
+    QVector<Card> deck;
+    for (uint id = 0; id < 32; ++id)
+        deck << Card::fromId(id);
+    std::random_shuffle(deck.begin(), deck.end());
+    GameEngine::PlayerList players;
+    for (int p = 0; p < 4; ++p) {
+        players << std::make_shared<BasePlayer>();
+        players.last()->setHand(deck.mid(p * 8, 8));
+    }
+    const auto contractor = GameEngine::Position(std::rand() % 4);
+    const auto trump = Card::Suits.at(std::rand() % 4);
+    return GameEngine::create(players, GameEngine::Position(std::rand() % 4), contractor, TrumpRule::Amsterdams, trump);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName(QStringLiteral("klaverjas-train"));
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Fit the value function used to shorten search playouts to rounds of self-play.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("output", "File to write the weights to.");
+    const QCommandLineOption gamesOption("games", "Number of rounds to play.", "n", "1000");
+    const QCommandLineOption iterationsOption("iterations", "Search iterations per move, 0 for random play.", "n", "100");
+    const QCommandLineOption epochsOption("epochs", "Number of passes over the records.", "n", "20");
+    const QCommandLineOption rateOption("rate", "Learning rate.", "r", "0.005");
+    parser.addOptions({gamesOption, iterationsOption, epochsOption, rateOption});
+    parser.process(app);
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(2);
+    QLoggingCategory::setFilterRules("klaverjas.*.debug=false");
+    std::srand(QTime::currentTime().msec());
+
+    const int games = parser.value(gamesOption).toInt();
+    const int iterations = parser.value(iterationsOption).toInt();
+    QTextStream out(stdout);
+    QVector<ValueFunction::Features> inputs;
+    QVector<std::array<float,2>> targets;
+    for (int game = 0; game < games; ++game) {
+        auto engine = randomDeal();
+        const int first = inputs.size();
+        while (!engine->isFinished()) {
+            if (engine->currentTrick().cards().isEmpty() && engine->tricksPlayed() > 0)
+                inputs << ValueFunction::features(*engine);
+            Card move;
+            if (iterations > 0) {
+                ISMCTS::SOSolver<Card> solver {std::size_t(iterations)};
+                move = solver(*engine);
+            } else {
+                const auto moves = engine->validMoves();
+                move = moves.at(std::rand() % moves.size());
+            }
+            engine->doMove(move);
+        }
+        const auto scores = engine->scores();
+        const uint contractors = uint(engine->contractor()) % 2;
+        const std::array<float,2> result {{scores[contractors].sum() / 162.0f, scores[1 - contractors].sum() / 162.0f}};
+        for (int i = first; i < inputs.size(); ++i)
+            targets << result;
+        if ((game + 1) % 100 == 0)
+            out << "played " << game + 1 << " rounds\n" << flush;
+    }
+
+    ValueFunction function;
+    const qreal error = function.train(inputs, targets, parser.value(epochsOption).toInt(), parser.value(rateOption).toDouble());
+    out << "fitted " << inputs.size() << " states, mean squared error " << error << '\n';
+    if (!function.save(parser.positionalArguments().first())) {
+        std::fprintf(stderr, "Cannot write %s\n", qPrintable(parser.positionalArguments().first()));
+        return 1;
+    }
+    return 0;
+}
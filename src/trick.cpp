@@ -77,6 +77,22 @@ void Trick::add(const Card card)
         checkBonus();
 }
 
+// The trick can no longer be complete, so only points and winner need undoing
+void Trick::removeLast()
+{
+    const auto card = m_cards.takeLast();
+    m_score.bonus = 0;
+    m_score.points -= cardValues(card.suit() == m_trumpSuit)[card.rank()];
+    m_winner = 0;
+    for (int i = 1; i < m_cards.size(); ++i) {
+        const auto &c = m_cards.at(i);
+        const auto &winning = m_cards.at(m_winner);
+        const bool isTrump = c.suit() == m_trumpSuit;
+        if (c.suit() == winning.suit() ? ranking(c.rank(), isTrump) > ranking(winning.rank(), isTrump) : isTrump)
+            m_winner = i;
+    }
+}
+
 /* Each time a new card is played, we check whether it beats the previous card;
  * if so, this player becomes the trick's current winner.
  *
@@ -92,8 +108,8 @@ void Trick::checkWinner()
     }
     const auto suitPlayed = card.suit();
     if (suitPlayed == winningCard().suit()) {
-        const auto order = rankOrder(suitPlayed == m_trumpSuit);
-        if (card.beats(winningCard(), order))
+        const bool isTrump = suitPlayed == m_trumpSuit;
+        if (ranking(card.rank(), isTrump) > ranking(winningCard().rank(), isTrump))
             m_winner = m_cards.size() - 1;
     } else if (suitPlayed == m_trumpSuit) {
         m_winner = m_cards.size() - 1;
@@ -61,6 +61,8 @@ public:
     Trick(Card::Suit trumpSuit);
 
     void add(const Card card);
+    /// Take back the last card added
+    void removeLast();
     const QVector<Card> &cards() const;
     Score score() const;
     Card::Suit suitLed() const;
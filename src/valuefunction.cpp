@@ -0,0 +1,154 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "valuefunction.h"
+#include "gameengine.h"
+
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTextStream>
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+const char *const FileHeader = "klaverjas-value";
+const int FileVersion = 1;
+
+QMutex sharedMutex;
+std::shared_ptr<const ValueFunction> sharedFunction;
+
+} // namespace
+
+ValueFunction::ValueFunction()
+{
+    for (auto &w : m_weights)
+        w.fill(0);
+}
+
+/* Features are laid out as one block of 32 card features per seat, counted
+ * clockwise from the contractor, followed by the contractors' and defenders'
+ * points, the tricks played, whether a march is possible and a constant.
+ */
+ValueFunction::Features ValueFunction::features(const GameEngine &state)
+{
+    Features x;
+    x.fill(0);
+    const uint contractor = uint(state.contractor());
+    const uint trump = Card::suitIndex(state.trumpSuit());
+    for (uint seat = 0; seat < 4; ++seat) {
+        for (const auto &card : state.hand((contractor + seat) % 4)) {
+            // Trump first, the other suits in their usual order
+            uint suit = Card::suitIndex(card.suit());
+            suit = suit == trump ? 0 : suit < trump ? suit + 1 : suit;
+            x[seat * 32 + suit * 8 + Card::rankIndex(card.rank())] = 1;
+        }
+    }
+    const auto scores = state.scores();
+    x[128] = scores[contractor % 2].sum() / 162.0f;
+    x[129] = scores[(contractor + 1) % 2].sum() / 162.0f;
+    x[130] = state.tricksPlayed() / 8.0f;
+    x[131] = state.isMarchPossible() ? 1 : 0;
+    x[132] = 1;
+    return x;
+}
+
+std::array<qreal,2> ValueFunction::evaluate(const GameEngine &state) const
+{
+    const auto x = features(state);
+    const uint contractors = uint(state.contractor()) % 2;
+    std::array<qreal,2> result;
+    result[contractors] = std::inner_product(x.begin(), x.end(), m_weights[0].begin(), 0.0);
+    result[1 - contractors] = std::inner_product(x.begin(), x.end(), m_weights[1].begin(), 0.0);
+    return result;
+}
+
+qreal ValueFunction::train(const QVector<Features> &inputs, const QVector<std::array<float,2>> &targets, int epochs, qreal learningRate)
+{
+    Q_ASSERT(inputs.size() == targets.size());
+    QVector<int> order(inputs.size());
+    std::iota(order.begin(), order.end(), 0);
+    qreal error = 0;
+    for (int epoch = 0; epoch < epochs; ++epoch) {
+        std::random_shuffle(order.begin(), order.end());
+        error = 0;
+        for (const int i : order) {
+            const auto &x = inputs.at(i);
+            for (int head = 0; head < 2; ++head) {
+                auto &w = m_weights[head];
+                const qreal delta = std::inner_product(x.begin(), x.end(), w.begin(), 0.0) - targets.at(i)[head];
+                error += delta * delta;
+                for (int f = 0; f < FeatureCount; ++f)
+                    w[f] -= float(learningRate * delta * x[f]);
+            }
+        }
+        error /= qMax(1, 2 * inputs.size());
+    }
+    return error;
+}
+
+std::shared_ptr<const ValueFunction> ValueFunction::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return nullptr;
+    QTextStream in(&file);
+    QString header;
+    int version = 0, count = 0;
+    in >> header >> version >> count;
+    if (header != FileHeader || version != FileVersion || count != FeatureCount)
+        return nullptr;
+    std::shared_ptr<ValueFunction> function(new ValueFunction);
+    for (auto &w : function->m_weights) {
+        for (auto &weight : w)
+            in >> weight;
+    }
+    if (in.status() != QTextStream::Ok)
+        return nullptr;
+    return function;
+}
+
+bool ValueFunction::save(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+    QTextStream out(&file);
+    out << FileHeader << ' ' << FileVersion << ' ' << FeatureCount << '\n';
+    for (const auto &w : m_weights) {
+        for (const auto weight : w)
+            out << weight << ' ';
+        out << '\n';
+    }
+    return out.status() == QTextStream::Ok;
+}
+
+std::shared_ptr<const ValueFunction> ValueFunction::shared()
+{
+    QMutexLocker lock(&sharedMutex);
+    return sharedFunction;
+}
+
+void ValueFunction::setShared(std::shared_ptr<const ValueFunction> function)
+{
+    QMutexLocker lock(&sharedMutex);
+    sharedFunction = std::move(function);
+}
@@ -0,0 +1,77 @@
+/*
+ * This file is part of Klaverjas.
+ * Copyright (C) 2018  Steven Franzen <sfranzen85@gmail.com>
+ *
+ * Klaverjas is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Klaverjas is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef VALUEFUNCTION_H
+#define VALUEFUNCTION_H
+
+#include <QString>
+#include <QVector>
+
+#include <array>
+#include <memory>
+
+class GameEngine;
+
+/**
+ * Linear estimate of the final scores of a round from a state in progress.
+ *
+ * The state is described from the contractor's point of view: which of the
+ * four seats, counted from the contractor, holds each card, with the trump
+ * suit relabelled as the first suit; the points both teams have won; the
+ * number of tricks played; and whether a march is still possible. Each team's
+ * final score, as a fraction of 162 like GameEngine::getResult, is a weighted
+ * sum of these features.
+ *
+ * The weights are fitted offline to rounds of self-play by klaverjas-train
+ * and loaded from a text file. A search can then stop its playouts after a
+ * few tricks and use the estimate instead, see GameEngine::setValueFunction.
+ */
+class ValueFunction
+{
+public:
+    static const int FeatureCount = 4 * 32 + 5;
+    /// Tricks played by searches before the estimate is used
+    static const int PlayoutTricks = 2;
+    using Features = std::array<float,FeatureCount>;
+
+    /// A state with all weights zero
+    ValueFunction();
+
+    /// The features of a state
+    static Features features(const GameEngine &state);
+    /// Estimated final results of both teams, indexed like GameEngine::scores
+    std::array<qreal,2> evaluate(const GameEngine &state) const;
+
+    /// Fit the weights by stochastic gradient descent, returning the mean squared error
+    qreal train(const QVector<Features> &inputs, const QVector<std::array<float,2>> &targets, int epochs, qreal learningRate);
+
+    /// Read weights written by save; returns nullptr if the file is invalid
+    static std::shared_ptr<const ValueFunction> load(const QString &fileName);
+    bool save(const QString &fileName) const;
+
+    /// The function used by searches unless another one is given, if any
+    static std::shared_ptr<const ValueFunction> shared();
+    static void setShared(std::shared_ptr<const ValueFunction> function);
+
+private:
+    // Weights for the contractors and the defenders
+    std::array<Features,2> m_weights;
+};
+
+#endif // VALUEFUNCTION_H